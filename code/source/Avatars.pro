@@ -16,7 +16,7 @@
 # *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
 # */
 
-QT       += core gui
+QT       += core gui network
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -44,6 +44,9 @@ unix {
     LIBS += -lrevel
     LIBS += -L/usr/lib/x86_64-linux-gnu/libxvidcore.a
     LIBS += -lxvidcore
+    # Encoding threads
+    QMAKE_CXXFLAGS += -pthread
+    LIBS += -pthread
     #LIBS += -lX11
 }
 
@@ -62,7 +65,29 @@ SOURCES += src/main.cpp \
     src/avatarsfactory.cpp \
     src/settingsparser.cpp \
     src/science.cpp \
-    src/vectorsequence.cpp
+    src/vectorsequence.cpp \
+    src/yuvconverter.cpp \
+    src/revelvideosink.cpp \
+    src/rawvideosink.cpp \
+    src/aviwriter.cpp \
+    src/xvidsegmentencoder.cpp \
+    src/parallelvideosink.cpp \
+    src/recordingmanifest.cpp \
+    src/avireader.cpp \
+    src/videojoiner.cpp \
+    src/renderdaemon.cpp \
+    src/renderclient.cpp \
+    src/cameraview.cpp \
+    src/posecache.cpp \
+    src/posescenenode.cpp \
+    src/jerseyatlas.cpp \
+    src/frameprofiler.cpp \
+    src/tracerecorder.cpp \
+    src/trajectoryparser.cpp \
+    src/kinematics.cpp \
+    src/nullvideosink.cpp \
+    src/framecache.cpp \
+    src/camerapath.cpp
 
 HEADERS += src/mainwindow.h \
         src/camerawindow.h \
@@ -85,7 +110,31 @@ HEADERS += src/mainwindow.h \
     src/actionsettings.h \
     src/science.h \
     src/vectorsequence.h \
-    src/itimeable.h
+    src/itimeable.h \
+    src/yuvconverter.h \
+    src/videosink.h \
+    src/revelvideosink.h \
+    src/rawvideosink.h \
+    src/aviwriter.h \
+    src/xvidsegmentencoder.h \
+    src/parallelvideosink.h \
+    src/recordingmanifest.h \
+    src/avireader.h \
+    src/videojoiner.h \
+    src/renderdaemon.h \
+    src/renderclient.h \
+    src/cameraview.h \
+    src/viewsettings.h \
+    src/posecache.h \
+    src/posescenenode.h \
+    src/jerseyatlas.h \
+    src/frameprofiler.h \
+    src/tracerecorder.h \
+    src/trajectoryparser.h \
+    src/kinematics.h \
+    src/nullvideosink.h \
+    src/framecache.h \
+    src/camerapath.h
 
 FORMS    += src/mainwindow.ui
 
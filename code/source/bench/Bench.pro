@@ -0,0 +1,54 @@
+#/*
+# *  Copyright 2014 Pierre Walch
+# *  Website : www.pwalch.net
+# *
+# *  Avatars is free software: you can redistribute it and/or modify
+# *  it under the terms of the GNU General Public License as published by
+# *  the Free Software Foundation, either version 3 of the License, or
+# *  (at your option) any later version.
+
+# *  Avatars is distributed in the hope that it will be useful,
+# *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+# *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# *  GNU General Public License for more details.
+
+# *  You should have received a copy of the GNU General Public License
+# *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+# */
+
+# Benchmarks of the data-path primitives, built without Qt and run without display
+CONFIG += console c++11
+CONFIG -= qt app_bundle
+
+QMAKE_CXXFLAGS += -Werror "-Wno-unused-parameter"
+
+TARGET = AvatarsBench
+TEMPLATE = app
+
+INCLUDEPATH += ../src
+
+win32 {
+    INCLUDEPATH += C:\Irrlicht\irrlicht-1.7.1\include
+}
+
+unix {
+    # Only the header-only core types of Irrlicht are used, the library is not linked
+    INCLUDEPATH += /usr/include/irrlicht
+}
+
+SOURCES += main.cpp \
+    benchmark.cpp \
+    ../src/vectorsequence.cpp \
+    ../src/science.cpp \
+    ../src/trajectoryparser.cpp \
+    ../src/kinematics.cpp \
+    ../src/affinetransformation.cpp \
+    ../src/yuvconverter.cpp
+
+HEADERS += benchmark.h \
+    ../src/vectorsequence.h \
+    ../src/science.h \
+    ../src/trajectoryparser.h \
+    ../src/kinematics.h \
+    ../src/affinetransformation.h \
+    ../src/yuvconverter.h
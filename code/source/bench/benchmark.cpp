@@ -0,0 +1,60 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include "benchmark.h"
+
+Benchmark::Benchmark(std::ostream& out, double minSeconds)
+    : mOut(out), mMinSeconds(minSeconds)
+{
+    mIsFirstResult = true;
+    mChecksum = 0;
+    mOut << "{\"results\":[";
+}
+
+void Benchmark::run(const std::string& name, long long size, const std::function<double()>& body)
+{
+    double bestSeconds = -1;
+    double totalSeconds = 0;
+    int repetitions = 0;
+    while(repetitions == 0 || totalSeconds < mMinSeconds) {
+        auto begin = std::chrono::steady_clock::now();
+        mChecksum += body();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+        if(bestSeconds < 0 || elapsed.count() < bestSeconds)
+            bestSeconds = elapsed.count();
+        totalSeconds += elapsed.count();
+        ++repetitions;
+    }
+
+    mOut << (mIsFirstResult ? "\n" : ",\n");
+    mIsFirstResult = false;
+    mOut << "{\"name\":\"" << name << "\",\"size\":" << size << ",\"repetitions\":" << repetitions
+         << ",\"seconds\":" << bestSeconds << ",\"nsPerItem\":" << bestSeconds * 1e9 / size << "}";
+    mOut.flush();
+
+    // Progress goes to the console when results are redirected
+    std::cerr << name << " " << size << ": " << bestSeconds * 1e9 / size << " ns/item" << std::endl;
+}
+
+void Benchmark::finish()
+{
+    mOut << "\n],\"checksum\":" << mChecksum << "}" << std::endl;
+}
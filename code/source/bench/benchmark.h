@@ -0,0 +1,69 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <ostream>
+#include <functional>
+
+/**
+ * @brief Times data-path primitives and writes the results as JSON
+ *
+ * Each case is repeated until it has run for a minimum time, and the fastest repetition is kept, so that
+ * results are comparable from one run to another. Results are written as a single JSON object whose
+ * "results" array holds one entry per case and input size.
+ */
+class Benchmark
+{
+
+public:
+
+    /**
+     * Starts the JSON document
+     * @param out stream receiving the results
+     * @param minSeconds minimum running time of each case
+     */
+    Benchmark(std::ostream& out, double minSeconds);
+
+    /**
+     * Times a case. The body returns a value depending on its results, so that the compiler cannot remove it.
+     * @param name name of the case
+     * @param size number of items processed by one call of the body
+     * @param body code to time
+     */
+    void run(const std::string& name, long long size, const std::function<double()>& body);
+
+    /**
+     * Ends the JSON document
+     */
+    void finish();
+
+private:
+
+    Benchmark& operator= (const Benchmark&);
+    Benchmark(const Benchmark&);
+
+    std::ostream& mOut;
+    double mMinSeconds;
+    bool mIsFirstResult;
+    double mChecksum;
+};
+
+#endif // BENCHMARK_H
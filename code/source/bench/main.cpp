@@ -0,0 +1,281 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include "benchmark.h"
+#include "vectorsequence.h"
+#include "science.h"
+#include "trajectoryparser.h"
+#include "kinematics.h"
+#include "affinetransformation.h"
+#include "yuvconverter.h"
+
+namespace
+{
+    // Lines are parsed from a pool, so that large sizes do not need one string per sample
+    const int nbPoolLines = 4096;
+
+    /**
+     * Creates a sequence following a random walk, with a hole of 1 to maxGap frames after some frames
+     */
+    VectorSequence createWalk(int size, std::mt19937& random, float gapProbability, int maxGap)
+    {
+        std::uniform_real_distribution<float> step(-50.f, 50.f);
+        std::uniform_real_distribution<float> uniform(0.f, 1.f);
+        std::uniform_int_distribution<int> gap(1, maxGap);
+
+        VectorSequence sequence;
+        vector3df position(0, 0, 0);
+        for(int time = 0; time < size; ++time) {
+            position += vector3df(step(random), 0, step(random));
+            sequence.set(time, position);
+            // First frame is always there, a query before it would not find any value
+            if(uniform(random) < gapProbability)
+                time += gap(random);
+        }
+        return sequence;
+    }
+
+    std::vector<std::string> createLines(int nbTokens, std::mt19937& random)
+    {
+        std::uniform_real_distribution<float> coordinate(-50000.f, 50000.f);
+        std::vector<std::string> lines;
+        for(int i = 0; i < nbPoolLines; ++i) {
+            std::ostringstream line;
+            line << i;
+            for(int t = 1; t < nbTokens; ++t)
+                line << " " << coordinate(random);
+            lines.push_back(line.str());
+        }
+        return lines;
+    }
+
+    std::map<AnimationAction, ActionSettings> createActions()
+    {
+        std::map<AnimationAction, ActionSettings> actions;
+        actions[AnimationAction::Stand].mBegin = 0;
+        actions[AnimationAction::Stand].mEnd = 29;
+        actions[AnimationAction::Walk].mThreshold = 0.5f;
+        actions[AnimationAction::Walk].mBegin = 30;
+        actions[AnimationAction::Walk].mEnd = 59;
+        actions[AnimationAction::Run].mThreshold = 3.f;
+        actions[AnimationAction::Run].mBegin = 60;
+        actions[AnimationAction::Run].mEnd = 89;
+        return actions;
+    }
+
+    void runSize(Benchmark& benchmark, int size)
+    {
+        std::mt19937 random(size);
+
+        benchmark.run("VectorSequence::set", size, [size, &random]() {
+            VectorSequence sequence;
+            for(int time = 0; time < size; ++time)
+                sequence.set(time, vector3df((f32) time, 0, 0));
+            return (double) sequence.getBegin();
+        });
+
+        auto dense = createWalk(size, random, 0, 0);
+        benchmark.run("VectorSequence::get", size, [size, &dense]() {
+            double sum = 0;
+            for(int time = 0; time < size; ++time)
+                sum += dense.get(time).X;
+            return sum;
+        });
+
+        // Missing frames hold the previous value, found by looking back one frame at a time
+        auto sparse = createWalk(size, random, 0.25f, 8);
+        benchmark.run("VectorSequence::get gaps", size, [size, &sparse]() {
+            double sum = 0;
+            for(int time = 0; time < size; ++time)
+                sum += sparse.get(time).X;
+            return sum;
+        });
+
+        // Output images between two frames, at twice the frame rate
+        benchmark.run("VectorSequence::getCatmullRom", size, [size, &dense]() {
+            double sum = 0;
+            for(int time = 0; time < size; ++time)
+                sum += dense.getCatmullRom(time + 0.5).X;
+            return sum;
+        });
+
+        // Trajectories grow by chunks, as in live mode
+        const int chunkLength = 1000;
+        std::vector<VectorSequence> chunks;
+        for(int begin = 0; begin < size; begin += chunkLength) {
+            VectorSequence chunk;
+            for(int time = begin; time < begin + chunkLength && time < size; ++time)
+                chunk.set(time, dense.get(time));
+            chunks.push_back(chunk);
+        }
+        benchmark.run("VectorSequence::merge", size, [&chunks]() {
+            VectorSequence sequence;
+            for(auto& chunk : chunks)
+                sequence.merge(chunk);
+            return (double) sequence.getBegin();
+        });
+
+        auto cameraLines = createLines(7, random);
+        benchmark.run("Science::split", size, [size, &cameraLines]() {
+            double count = 0;
+            for(int i = 0; i < size; ++i)
+                count += Science::split(cameraLines[i % nbPoolLines]).size();
+            return count;
+        });
+
+        auto playerLines = createLines(4, random);
+        benchmark.run("TrajectoryParser::getPlayerTokens", size, [size, &playerLines]() {
+            double sum = 0;
+            for(int i = 0; i < size; ++i)
+                sum += std::get<2>(TrajectoryParser::getPlayerTokens(playerLines[i % nbPoolLines])).X;
+            return sum;
+        });
+
+        auto ballLines = createLines(4, random);
+        benchmark.run("TrajectoryParser::getBallTokens", size, [size, &ballLines]() {
+            double sum = 0;
+            for(int i = 0; i < size; ++i)
+                sum += std::get<1>(TrajectoryParser::getBallTokens(ballLines[i % nbPoolLines])).X;
+            return sum;
+        });
+
+        benchmark.run("TrajectoryParser::getCameraTokens", size, [size, &cameraLines]() {
+            double sum = 0;
+            for(int i = 0; i < size; ++i)
+                sum += std::get<1>(TrajectoryParser::getCameraTokens(cameraLines[i % nbPoolLines])).X;
+            return sum;
+        });
+
+        // Settings of the sample context: 25 fps, derivative over 5 frames, averager of 10 points
+        benchmark.run("Kinematics::storeSpeed", size, [&dense]() {
+            VectorSequence speeds;
+            Kinematics::storeSpeed(dense, 0, 5, 25, speeds);
+            return (double) speeds.get(speeds.getEnd()).X;
+        });
+
+        VectorSequence speeds;
+        Kinematics::storeSpeed(dense, 0, 5, 25, speeds);
+        benchmark.run("Kinematics::storeSmoothed", size, [&speeds]() {
+            VectorSequence smoothed;
+            Kinematics::storeSmoothed(speeds, 0, 10, smoothed);
+            return (double) smoothed.get(smoothed.getEnd()).X;
+        });
+
+        std::map<int, float> timeToSpeed;
+        std::uniform_real_distribution<float> speed(0.f, 6.f);
+        for(int time = 0; time < size; ++time)
+            timeToSpeed[time] = speed(random);
+        auto actions = createActions();
+        benchmark.run("Kinematics::computeAnimations", size, [&timeToSpeed, &actions]() {
+            auto timeToFrame = Kinematics::computeAnimations(timeToSpeed, actions, 1, std::map<int, int>());
+            return (double) timeToFrame.rbegin()->second;
+        });
+
+        std::vector<vector3df> points;
+        for(int time = 0; time < size; ++time)
+            points.push_back(dense.get(time));
+        AffineTransformation transformation(vector3df(0.01f, 0.01f, 0.01f), vector3df(-5000, 0, -2500));
+        benchmark.run("AffineTransformation::convertToVirtual", size, [&points, &transformation]() {
+            double sum = 0;
+            for(auto& point : points)
+                sum += transformation.convertToVirtual(point).X;
+            return sum;
+        });
+        benchmark.run("AffineTransformation::convertToReal", size, [&points, &transformation]() {
+            double sum = 0;
+            for(auto& point : points)
+                sum += transformation.convertToReal(point).X;
+            return sum;
+        });
+
+        std::vector<vector3df> converted(points.size());
+        benchmark.run("AffineTransformation::convertToVirtual batch", size, [&points, &converted, &transformation]() {
+            transformation.convertToVirtual(points.data(), converted.data(), points.size());
+            return (double) converted.back().X;
+        });
+        benchmark.run("AffineTransformation::convertToReal batch", size, [&points, &converted, &transformation]() {
+            transformation.convertToReal(points.data(), converted.data(), points.size());
+            return (double) converted.back().X;
+        });
+    }
+
+    void runYuvConverter(Benchmark& benchmark)
+    {
+        const int width = 1920;
+        const int height = 1080;
+        std::vector<unsigned char> bgra(width * height * 4);
+        std::mt19937 random(width);
+        for(auto& byte : bgra)
+            byte = (unsigned char) random();
+
+        YuvConverter converter(width, height);
+        benchmark.run(std::string("YuvConverter::convert ") + YuvConverter::getKernelName(), width * height,
+                      [&converter, &bgra]() {
+            converter.convert(bgra.data(), width * 4);
+            return (double) converter.getData()[0];
+        });
+    }
+}
+
+/**
+ * Runs the benchmarks for sizes from 1000 samples to the maximum size, multiplied by 10 at each step.
+ * Arguments: [--max size] [--time seconds] [--output file.json]. Results go to the standard output by default.
+ */
+int main(int argc, char* argv[])
+{
+    long long maxSize = 10000000;
+    double minSeconds = 0.5;
+    std::string outputName;
+    for(int i = 1; i + 1 < argc; i += 2) {
+        if(strcmp(argv[i], "--max") == 0) {
+            maxSize = atoll(argv[i + 1]);
+        } else if(strcmp(argv[i], "--time") == 0) {
+            minSeconds = atof(argv[i + 1]);
+        } else if(strcmp(argv[i], "--output") == 0) {
+            outputName = argv[i + 1];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--max size] [--time seconds] [--output file.json]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::ofstream outputFile;
+    if(!outputName.empty()) {
+        outputFile.open(outputName.c_str());
+        if(!outputFile.is_open()) {
+            std::cerr << "Output file cannot be opened: " << outputName << std::endl;
+            return 1;
+        }
+    }
+
+    Benchmark benchmark(outputName.empty() ? std::cout : outputFile, minSeconds);
+    for(long long size = 1000; size <= maxSize; size *= 10)
+        runSize(benchmark, (int) size);
+    runYuvConverter(benchmark);
+    benchmark.finish();
+
+    return 0;
+}
@@ -18,6 +18,44 @@
 
 #include "affinetransformation.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AFFINE_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+// Kernels read arrays of vectors as arrays of floats
+static_assert(sizeof(vector3df) == 3 * sizeof(float), "vector3df must be made of three packed floats");
+
+#ifdef AFFINE_HAS_SSE2
+
+/**
+ * Four vectors fill three registers, in which a pattern of three components repeats:
+ * [c0 c1 c2 c0] [c1 c2 c0 c1] [c2 c0 c1 c2]
+ */
+static inline void setPatternSSE2(const vector3df& vector, __m128& v0, __m128& v1, __m128& v2)
+{
+    v0 = _mm_setr_ps(vector.X, vector.Y, vector.Z, vector.X);
+    v1 = _mm_setr_ps(vector.Y, vector.Z, vector.X, vector.Y);
+    v2 = _mm_setr_ps(vector.Z, vector.X, vector.Y, vector.Z);
+}
+
+/**
+ * Swaps Y and Z of the four vectors held in three registers
+ * [x0 y0 z0 x1] [y1 z1 x2 y2] [z2 x3 y3 z3] -> [x0 z0 y0 x1] [z1 y1 x2 z2] [y2 x3 z3 y3]
+ */
+static inline void swapAxesSSE2(__m128& v0, __m128& v1, __m128& v2)
+{
+    v0 = _mm_shuffle_ps(v0, v0, _MM_SHUFFLE(3, 1, 2, 0));
+    // [z1 y1 x2 y2] and [z2 x3 z3 y3], the last component of the first being exchanged with the first of the second
+    __m128 a = _mm_shuffle_ps(v1, v1, _MM_SHUFFLE(3, 2, 0, 1));
+    __m128 b = _mm_shuffle_ps(v2, v2, _MM_SHUFFLE(2, 3, 1, 0));
+    __m128 high = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 2, 2));
+    v1 = _mm_shuffle_ps(a, high, _MM_SHUFFLE(2, 0, 1, 0));
+    v2 = _mm_move_ss(b, _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)));
+}
+
+#endif
+
 AffineTransformation::AffineTransformation(const vector3df& scale, const vector3df& offset)
 {
     this->mScale = scale;
@@ -37,3 +75,62 @@ vector3df AffineTransformation::convertToReal(vector3df vrtl) const
                      (vrtl.Z - offset.Y) / mScale.Y,
                      (vrtl.Y - offset.Z) / mScale.Z);
 }
+
+void AffineTransformation::convertToVirtual(const vector3df* realVectors, vector3df* virtualVectors, size_t count) const
+{
+    size_t i = 0;
+#ifdef AFFINE_HAS_SSE2
+    // Scale and offset follow the real component, so they are applied before swapping the axes
+    __m128 scale0, scale1, scale2, offset0, offset1, offset2;
+    setPatternSSE2(mScale, scale0, scale1, scale2);
+    setPatternSSE2(offset, offset0, offset1, offset2);
+
+    const float* source = reinterpret_cast<const float*>(realVectors);
+    float* destination = reinterpret_cast<float*>(virtualVectors);
+    for(; i + 4 <= count; i += 4) {
+        __m128 v0 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(source), scale0), offset0);
+        __m128 v1 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(source + 4), scale1), offset1);
+        __m128 v2 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(source + 8), scale2), offset2);
+        swapAxesSSE2(v0, v1, v2);
+        _mm_storeu_ps(destination, v0);
+        _mm_storeu_ps(destination + 4, v1);
+        _mm_storeu_ps(destination + 8, v2);
+        source += 12;
+        destination += 12;
+    }
+#endif
+
+    for(; i < count; ++i) {
+        virtualVectors[i] = convertToVirtual(realVectors[i]);
+    }
+}
+
+void AffineTransformation::convertToReal(const vector3df* virtualVectors, vector3df* realVectors, size_t count) const
+{
+    size_t i = 0;
+#ifdef AFFINE_HAS_SSE2
+    // Scale and offset follow the real component, so they are applied after swapping the axes. Division is
+    // kept instead of a multiplication by the inverse, to give the same results as convertToReal()
+    __m128 scale0, scale1, scale2, offset0, offset1, offset2;
+    setPatternSSE2(mScale, scale0, scale1, scale2);
+    setPatternSSE2(offset, offset0, offset1, offset2);
+
+    const float* source = reinterpret_cast<const float*>(virtualVectors);
+    float* destination = reinterpret_cast<float*>(realVectors);
+    for(; i + 4 <= count; i += 4) {
+        __m128 v0 = _mm_loadu_ps(source);
+        __m128 v1 = _mm_loadu_ps(source + 4);
+        __m128 v2 = _mm_loadu_ps(source + 8);
+        swapAxesSSE2(v0, v1, v2);
+        _mm_storeu_ps(destination, _mm_div_ps(_mm_sub_ps(v0, offset0), scale0));
+        _mm_storeu_ps(destination + 4, _mm_div_ps(_mm_sub_ps(v1, offset1), scale1));
+        _mm_storeu_ps(destination + 8, _mm_div_ps(_mm_sub_ps(v2, offset2), scale2));
+        source += 12;
+        destination += 12;
+    }
+#endif
+
+    for(; i < count; ++i) {
+        realVectors[i] = convertToReal(virtualVectors[i]);
+    }
+}
@@ -19,6 +19,7 @@
 #ifndef AFFINETRANSFORMATION_H
 #define AFFINETRANSFORMATION_H
 
+#include <cstddef>
 #include "irrlicht.h"
 
 using namespace irr::core;
@@ -26,7 +27,9 @@ using namespace irr::core;
 /**
  * @brief Handles an affine transformation between the real coordinate system and the virtual one
  *
- * Represents the affine transformation used to convert real coordinates to virtual coordinates and conversely
+ * Represents the affine transformation used to convert real coordinates to virtual coordinates and conversely.
+ * Virtual coordinates swap the Y and Z axes, since Irrlicht uses Y as the vertical axis. Whole trajectories are
+ * converted with the array methods, which use an SSE2 kernel when the processor supports it.
  */
 class AffineTransformation
 {
@@ -53,6 +56,24 @@ public:
      */
     vector3df convertToReal(vector3df virtualVector) const;
 
+    /**
+     * Converts an array of real vectors to virtual Irrlicht coordinates, giving the same results as
+     * convertToVirtual() on each vector. Arrays may be the same, but must not overlap otherwise.
+     * @param realVectors first real vector
+     * @param virtualVectors first virtual vector, written
+     * @param count number of vectors
+     */
+    void convertToVirtual(const vector3df* realVectors, vector3df* virtualVectors, size_t count) const;
+
+    /**
+     * Converts an array of virtual vectors to real coordinates, giving the same results as convertToReal()
+     * on each vector. Arrays may be the same, but must not overlap otherwise.
+     * @param virtualVectors first virtual vector
+     * @param realVectors first real vector, written
+     * @param count number of vectors
+     */
+    void convertToReal(const vector3df* virtualVectors, vector3df* realVectors, size_t count) const;
+
 private:
     vector3df mScale;
     vector3df offset;
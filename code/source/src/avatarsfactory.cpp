@@ -19,13 +19,22 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <vector>
+#include <thread>
 #include <QDesktopWidget>
+#include <QFileInfo>
+#include <QDateTime>
 #include "engine.h"
 #include "science.h"
+#include "trajectoryparser.h"
 #include "camerawindow.h"
+#include "revelvideosink.h"
+#include "rawvideosink.h"
+#include "nullvideosink.h"
+#include "parallelvideosink.h"
 #include "avatarsfactory.h"
 
-AvatarsFactory::AvatarsFactory(std::string cfgPath)
+AvatarsFactory::AvatarsFactory(Engine& engine, std::string cfgPath) : mEngine(engine), mCfgPath(cfgPath)
 {
     mSettingsParser = std::unique_ptr<SettingsParser>(new SettingsParser(cfgPath.c_str()));
 }
@@ -35,20 +44,41 @@ AvatarsFactory::~AvatarsFactory()
 
 }
 
-std::unique_ptr<CameraWindow> AvatarsFactory::createCamera() const
+std::string AvatarsFactory::describeInputs() const
 {
-    Engine& e = Engine::getInstance();
+    // Settings of the cameras, the sequence and the court are covered by the modification time of the configuration
+    std::ostringstream description;
+    auto describeFile = [&description](const std::string& path) {
+        QFileInfo info(QString::fromStdString(path));
+        description << info.absoluteFilePath().toStdString() << " " << info.lastModified().toTime_t() << "\n";
+    };
+    describeFile(mCfgPath);
+    describeFile(mSettingsParser->retrieveCameraTrajectoryPath());
+    describeFile(mSettingsParser->retrievePlayerTrajectoryPath());
+    describeFile(mSettingsParser->retrieveBallTrajectoryPath());
+    for(auto& viewSettings : mSettingsParser->retrieveViewSettings())
+        describeFile(viewSettings.mTrajectoryPath);
+
+    return description.str();
+}
 
-    auto cameraSettings = mSettingsParser->retrieveCameraSettings();
+CameraSettings AvatarsFactory::retrieveCameraSettings() const
+{
+    return mSettingsParser->retrieveCameraSettings();
+}
+
+std::unique_ptr<CameraWindow> AvatarsFactory::createCamera() const
+{
+    auto cameraSettings = retrieveCameraSettings();
 
     auto screenSize = QApplication::desktop()->geometry();
     if(cameraSettings.mWindowSize.Width > ((unsigned int)screenSize.width())
             || cameraSettings.mWindowSize.Height > ((unsigned int)screenSize.height())) {
-        e.throwError("Window size is bigger than screen size");
+        Engine::throwError("Window size is bigger than screen size");
     }
 
     // Actual instance creation
-    return std::unique_ptr<CameraWindow>(new CameraWindow(cameraSettings));
+    return std::unique_ptr<CameraWindow>(new CameraWindow(mEngine, cameraSettings));
 }
 
 std::unique_ptr<std::istream> AvatarsFactory::createCameraStream() const
@@ -56,18 +86,38 @@ std::unique_ptr<std::istream> AvatarsFactory::createCameraStream() const
     auto cameraFile = std::unique_ptr<std::ifstream>(new std::ifstream());
     cameraFile->open(mSettingsParser->retrieveCameraTrajectoryPath());
     if(!cameraFile->is_open()) {
-        Engine::getInstance().throwError(L"Camera trajectory file cannot be opened");
+        Engine::throwError(L"Camera trajectory file cannot be opened");
     }
 
     return std::unique_ptr<std::istream>(std::move(cameraFile));
 }
 
+std::vector<std::unique_ptr<CameraView>> AvatarsFactory::createViews() const
+{
+    std::vector<std::unique_ptr<CameraView>> views;
+    for(auto& viewSettings : mSettingsParser->retrieveViewSettings())
+        views.push_back(std::unique_ptr<CameraView>(new CameraView(mEngine, viewSettings)));
+
+    return views;
+}
+
+std::unique_ptr<std::istream> AvatarsFactory::createViewStream(const CameraView& view) const
+{
+    auto viewFile = std::unique_ptr<std::ifstream>(new std::ifstream());
+    viewFile->open(view.getSettings().mTrajectoryPath);
+    if(!viewFile->is_open()) {
+        Engine::throwError(L"Additional camera trajectory file cannot be opened");
+    }
+
+    return std::unique_ptr<std::istream>(std::move(viewFile));
+}
+
 std::unique_ptr<std::istream> AvatarsFactory::createPlayerStream() const
 {
     auto playerFile = std::unique_ptr<std::ifstream>(new std::ifstream());
     playerFile->open(mSettingsParser->retrievePlayerTrajectoryPath());
     if(!playerFile->is_open()) {
-        Engine::getInstance().throwError(L"Player trajectory file cannot be opened");
+        Engine::throwError(L"Player trajectory file cannot be opened");
     }
 
     return std::unique_ptr<std::istream>(std::move(playerFile));
@@ -78,7 +128,7 @@ std::unique_ptr<std::istream> AvatarsFactory::createBallStream() const
     auto ballFile = std::unique_ptr<std::ifstream>(new std::ifstream());
     ballFile->open(mSettingsParser->retrieveBallTrajectoryPath());
     if(!ballFile->is_open()) {
-        Engine::getInstance().throwError(L"Ball trajectory file cannot be opened");
+        Engine::throwError(L"Ball trajectory file cannot be opened");
     }
 
     return std::unique_ptr<std::istream>(std::move(ballFile));
@@ -86,12 +136,10 @@ std::unique_ptr<std::istream> AvatarsFactory::createBallStream() const
 
 const std::pair<VectorSequence, VectorSequence> AvatarsFactory::createCameraChunk(std::istream &cameraStream, int nbFramesToCatch) const
 {
-    Engine& engine = Engine::getInstance();
-    auto tfm = engine.getAffineTransformation();
-
-    // Create pair of maps: first for position and second for rotation
-    VectorSequence positions;
-    VectorSequence rotations;
+    // Positions are converted all at once after parsing
+    std::vector<int> frameIndexes;
+    std::vector<vector3df> realPositions;
+    std::vector<vector3df> realRotations;
 
     int counter = 0;
     while(!cameraStream.eof()) {
@@ -105,26 +153,69 @@ const std::pair<VectorSequence, VectorSequence> AvatarsFactory::createCameraChun
         if(line.compare("") != 0) {
             int frameIndex = 0;
             vector3df realPosition, rotation;
-            std::tie(frameIndex, realPosition, rotation) = SettingsParser::getCameraTokens(line);
+            std::tie(frameIndex, realPosition, rotation) = TrajectoryParser::getCameraTokens(line);
 
-            positions.set(frameIndex, tfm.convertToVirtual(realPosition));
-            rotations.set(frameIndex, rotation);
+            frameIndexes.push_back(frameIndex);
+            realPositions.push_back(realPosition);
+            realRotations.push_back(rotation);
 
             ++counter;
         }
     }
 
+    std::vector<vector3df> virtualPositions(realPositions.size());
+    mEngine.getAffineTransformation().convertToVirtual(realPositions.data(), virtualPositions.data(),
+                                                       realPositions.size());
+
+    // Create pair of maps: first for position and second for rotation
+    VectorSequence positions;
+    VectorSequence rotations;
+    for(size_t i = 0; i < frameIndexes.size(); ++i) {
+        positions.set(frameIndexes[i], virtualPositions[i]);
+        rotations.set(frameIndexes[i], realRotations[i]);
+    }
+
     return std::pair<VectorSequence, VectorSequence>(positions, rotations);
 }
 
+std::unique_ptr<CameraPath> AvatarsFactory::createCameraPath(std::istream& cameraStream) const
+{
+    std::vector<int> frameIndexes;
+    std::vector<vector3df> positions;
+    std::vector<vector3df> rotations;
+    std::string line = "";
+    while(std::getline(cameraStream, line)) {
+        if(line.compare("") != 0) {
+            int frameIndex = 0;
+            vector3df realPosition, rotation;
+            std::tie(frameIndex, realPosition, rotation) = TrajectoryParser::getCameraTokens(line);
+
+            frameIndexes.push_back(frameIndex);
+            positions.push_back(realPosition);
+            rotations.push_back(rotation);
+        }
+    }
+
+    mEngine.getAffineTransformation().convertToVirtual(positions.data(), positions.data(), positions.size());
+
+    auto path = std::unique_ptr<CameraPath>(new CameraPath());
+    for(size_t i = 0; i < frameIndexes.size(); ++i) {
+        path->addKeyframe(frameIndexes[i], positions[i], rotations[i]);
+    }
+
+    if(path->getKeyframeCount() == 0)
+        Engine::throwError(L"Keyframed camera trajectory is empty");
+
+    return path;
+}
+
 const std::map<int, VectorSequence > AvatarsFactory::createPlayerChunkMap(std::istream &playerStream,
                                                                       const std::map<int, std::unique_ptr<Player> >& playerMap,
                                                                       int framesToCatch) const
 {
-    Engine& engine = Engine::getInstance();
-    auto tfm = engine.getAffineTransformation();
-
-    std::map<int, VectorSequence > sequenceMap;
+    // Positions of all the players are converted at once after parsing
+    std::vector<std::pair<int, int> > playerFrameIndexes;
+    std::vector<vector3df> positions;
     unsigned int counter = 0;
     while(!playerStream.eof()) {
         if(counter >= framesToCatch * playerMap.size()) {
@@ -137,27 +228,32 @@ const std::map<int, VectorSequence > AvatarsFactory::createPlayerChunkMap(std::i
         if(line.compare("") != 0) {
             int frameIndex = 0, playerIndex = 0;
             vector2df pos2D;
-            std::tie(frameIndex, playerIndex, pos2D) = SettingsParser::getPlayerTokens(line);
+            std::tie(frameIndex, playerIndex, pos2D) = TrajectoryParser::getPlayerTokens(line);
 
             if(playerMap.find(playerIndex) != playerMap.end()) {
-                const vector3df realPosition(pos2D.X, pos2D.Y, 0);
-                VectorSequence& sequence = sequenceMap[playerIndex];
-                sequence.set(frameIndex, tfm.convertToVirtual(realPosition));
+                playerFrameIndexes.push_back(std::make_pair(playerIndex, frameIndex));
+                positions.push_back(vector3df(pos2D.X, pos2D.Y, 0));
 
                 ++counter;
             }
         }
     }
 
+    mEngine.getAffineTransformation().convertToVirtual(positions.data(), positions.data(), positions.size());
+
+    std::map<int, VectorSequence > sequenceMap;
+    for(size_t i = 0; i < positions.size(); ++i) {
+        sequenceMap[playerFrameIndexes[i].first].set(playerFrameIndexes[i].second, positions[i]);
+    }
+
     return sequenceMap;
 }
 
 const VectorSequence AvatarsFactory::createBallChunk(std::istream& ballStream, int framesToCatch) const
 {
-    Engine& engine = Engine::getInstance();
-    auto tfm = engine.getAffineTransformation();
-
-    VectorSequence positions;
+    // Positions are converted all at once after parsing
+    std::vector<int> frameIndexes;
+    std::vector<vector3df> realPositions;
     int counter = 0;
     while(!ballStream.eof()) {
         if(counter >= framesToCatch) {
@@ -169,25 +265,73 @@ const VectorSequence AvatarsFactory::createBallChunk(std::istream& ballStream, i
         if(line.compare("") != 0) {
             int frameIndex = 0;
             vector3df realPosition;
-            std::tie(frameIndex, realPosition) = SettingsParser::getBallTokens(line);
+            std::tie(frameIndex, realPosition) = TrajectoryParser::getBallTokens(line);
 
-            const vector3df virtualPosition = tfm.convertToVirtual(realPosition);
-            positions.set(frameIndex, virtualPosition);
+            frameIndexes.push_back(frameIndex);
+            realPositions.push_back(realPosition);
 
             ++counter;
         }
     }
 
+    std::vector<vector3df> virtualPositions(realPositions.size());
+    mEngine.getAffineTransformation().convertToVirtual(realPositions.data(), virtualPositions.data(),
+                                                       realPositions.size());
+
+    VectorSequence positions;
+    for(size_t i = 0; i < frameIndexes.size(); ++i) {
+        positions.set(frameIndexes[i], virtualPositions[i]);
+    }
+
     return positions;
 }
 
+std::unique_ptr<VideoSink> AvatarsFactory::createVideoSink(const SequenceSettings& sequenceSettings,
+                                                           const std::string& fileName,
+                                                           const dimension2d<u32>& frameSize) const
+{
+    // Benchmark measures the pipeline without encoding
+    if(sequenceSettings.mMode == MODE_BENCHMARK) {
+        return std::unique_ptr<VideoSink>(new NullVideoSink());
+    }
+
+    if(sequenceSettings.mVideoFormat == FORMAT_I420) {
+        return std::unique_ptr<VideoSink>(new RawVideoSink(fileName));
+    }
+
+    int nbThreads = sequenceSettings.mVideoThreads;
+    if(nbThreads == 0)
+        nbThreads = Science::max(1, (int) std::thread::hardware_concurrency());
+
+    if(nbThreads > 1) {
+        int segmentLength = sequenceSettings.mVideoSegmentLength;
+        if(segmentLength == 0)
+            segmentLength = 2 * sequenceSettings.mOutputFramerate;
+
+        return std::unique_ptr<VideoSink>(new ParallelVideoSink(fileName,
+                                                                frameSize.Width, frameSize.Height,
+                                                                sequenceSettings.mOutputFramerate,
+                                                                nbThreads, segmentLength,
+                                                                (size_t) sequenceSettings.mVideoMemory << 20));
+    }
+
+    return std::unique_ptr<VideoSink>(new RevelVideoSink(fileName,
+                                                         frameSize.Width, frameSize.Height,
+                                                         sequenceSettings.mOutputFramerate));
+}
+
 std::unique_ptr<Court> AvatarsFactory::createCourt() const
 {
     auto playerMap = createPlayerMap();
     auto ball = createBall();
     auto courtSettings = mSettingsParser->retrieveCourtSettings();
 
-    return std::unique_ptr<Court>(new Court(courtSettings, std::move(playerMap), std::move(ball)));
+    return std::unique_ptr<Court>(new Court(mEngine, courtSettings, std::move(playerMap), std::move(ball)));
+}
+
+std::unique_ptr<JerseyAtlas> AvatarsFactory::createJerseyAtlas() const
+{
+    return std::unique_ptr<JerseyAtlas>(new JerseyAtlas(mEngine, mSettingsParser->retrieveJerseyCachePath()));
 }
 
 std::unique_ptr<PlayerMap> AvatarsFactory::createPlayerMap() const
@@ -212,7 +356,7 @@ std::unique_ptr<PlayerMap> AvatarsFactory::createPlayerMap() const
         auto playerSettings = mSettingsParser->retrievePlayerSettings(team, jerseyNumber);
 
         // Instanciate the player and reference it in the map
-        (*playerMap)[playerIndex] = std::unique_ptr<Player>(new Player(playerBodySettings, playerSettings));
+        (*playerMap)[playerIndex] = std::unique_ptr<Player>(new Player(mEngine, playerBodySettings, playerSettings));
     }
 
     return playerMap;
@@ -223,24 +367,22 @@ std::unique_ptr<MovingBody> AvatarsFactory::createBall() const
 {
     auto ballBodySettings = mSettingsParser->retrieveBallBodySettings();
 
-    return std::unique_ptr<MovingBody>(new MovingBody(ballBodySettings));
+    return std::unique_ptr<MovingBody>(new MovingBody(mEngine, ballBodySettings));
 }
 
 SequenceSettings AvatarsFactory::retrieveSequenceSettings() const
 {
     auto sequenceSettings = mSettingsParser->retrieveSequenceSettings();
-    Engine& e = Engine::getInstance();
-
     if(sequenceSettings.mInitialTime < 0 || sequenceSettings.mInitialTime > (sequenceSettings.mFrameNumber - 1)) {
-        e.throwError(L"Invalid initial time index");
+        Engine::throwError(L"Invalid initial time index");
     }
 
     if(sequenceSettings.mStartTime < 0 || sequenceSettings.mStartTime > (sequenceSettings.mFrameNumber - 1)) {
-        e.throwError(L"Invalid recording start time index");
+        Engine::throwError(L"Invalid recording start time index");
     }
 
     if(sequenceSettings.mEndTime < 0 || sequenceSettings.mEndTime > (sequenceSettings.mFrameNumber - 1)) {
-        e.throwError(L"Invalid recording end time index");
+        Engine::throwError(L"Invalid recording end time index");
     }
 
     return sequenceSettings;
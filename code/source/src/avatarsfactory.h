@@ -27,6 +27,10 @@
 #include "engine.h"
 #include "court.h"
 #include "settingsparser.h"
+#include "videosink.h"
+#include "cameraview.h"
+#include "camerapath.h"
+#include "jerseyatlas.h"
 
 using namespace tinyxml2;
 
@@ -42,21 +46,35 @@ public:
 
     /**
      * Creates the parsing system and saves shortcuts of the main nodes and their subnodes
+     * @param engine engine owning the created objects
      * @param cfgPath configuration file to parse
      */
-    explicit AvatarsFactory(std::string cfgPath);
+    AvatarsFactory(Engine& engine, std::string cfgPath);
 
     /**
      * Releases memory of the SettingsParser instance
      */
     virtual ~AvatarsFactory();
 
+    /**
+     * Describes the configuration file and the trajectory files it refers to, with their modification times,
+     * so that outputs recorded from other inputs can be told apart
+     * @return description of the inputs, on several lines
+     */
+    std::string describeInputs() const;
+
     /**
      * Returns an initialized court according to configuration file
      * @return initialized court
      */
     std::unique_ptr<Court> createCourt() const;
 
+    /**
+     * Returns an empty jersey atlas, cached in the directory given by the configuration file
+     * @return jersey atlas, to be baked with the players of the court
+     */
+    std::unique_ptr<JerseyAtlas> createJerseyAtlas() const;
+
     /**
      * Returns sequence settings
      * @return sequence settings
@@ -69,6 +87,12 @@ public:
      */
     std::unique_ptr<AffineTransformation> createTransformation() const;
 
+    /**
+     * Returns camera settings
+     * @return camera settings
+     */
+    CameraSettings retrieveCameraSettings() const;
+
     /**
      * Creates camera window instance and initializes it
      */
@@ -80,6 +104,19 @@ public:
      */
     std::unique_ptr<std::istream> createCameraStream() const;
 
+    /**
+     * Creates the additional cameras of the configuration file. Must be called after createCamera()
+     * @return views, possibly empty
+     */
+    std::vector<std::unique_ptr<CameraView>> createViews() const;
+
+    /**
+     * Creates the trajectory input stream of an additional camera
+     * @param view additional camera
+     * @return input stream
+     */
+    std::unique_ptr<std::istream> createViewStream(const CameraView& view) const;
+
     /**
      * Creates a player trajectory input stream
      * @return input stream
@@ -92,6 +129,14 @@ public:
      */
     std::unique_ptr<std::istream> createBallStream() const;
 
+    /**
+     * Creates a keyframed camera path from a whole trajectory stream, whose lines have the same format
+     * as per-frame camera trajectories
+     * @param cameraStream stream to read until its end
+     * @return camera path
+     */
+    std::unique_ptr<CameraPath> createCameraPath(std::istream& cameraStream) const;
+
     /**
      * Create camera trajectory chunk obtained from the input stream
      * @param cameraStream stream to expore
@@ -119,8 +164,21 @@ public:
      */
     const VectorSequence createBallChunk(std::istream& ballStream, int framesToCatch) const;
 
+    /**
+     * Creates the sink receiving recorded frames, according to the output format of the sequence settings
+     * @param sequenceSettings sequence settings containing output format and encoding options
+     * @param fileName file to write, either the output of the sequence settings or a segment of it
+     * @param frameSize size of recorded frames
+     * @return video sink
+     */
+    std::unique_ptr<VideoSink> createVideoSink(const SequenceSettings& sequenceSettings,
+                                               const std::string& fileName,
+                                               const dimension2d<u32>& frameSize) const;
+
 
 private:
+    Engine& mEngine;
+    std::string mCfgPath;
     std::unique_ptr<SettingsParser> mSettingsParser;
 
     std::unique_ptr<MovingBody> createBall() const;
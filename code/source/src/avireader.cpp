@@ -0,0 +1,114 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include "engine.h"
+#include "avireader.h"
+
+namespace
+{
+    const unsigned int AVIIF_KEYFRAME = 0x10;
+}
+
+AviReader::AviReader(const std::string& fileName)
+{
+    mFile.open(fileName.c_str(), std::ios::in | std::ios::binary);
+    if(!mFile.is_open()) {
+        Engine::throwError(L"AVI input file cannot be opened");
+    }
+
+    char fourcc[4];
+    mFile.read(fourcc, 4);
+    read32();
+    char type[4];
+    mFile.read(type, 4);
+    if(!mFile.good() || memcmp(fourcc, "RIFF", 4) != 0 || memcmp(type, "AVI ", 4) != 0) {
+        Engine::throwError(L"AVI input file is not a RIFF AVI file");
+    }
+
+    // Walk through the top level chunks looking for the 'movi' list and the index
+    mMoviPos = 0;
+    bool hasIndex = false;
+    while(mFile.read(fourcc, 4)) {
+        unsigned int size = read32();
+        unsigned int dataPos = (unsigned int) mFile.tellg();
+
+        if(memcmp(fourcc, "LIST", 4) == 0) {
+            mFile.read(type, 4);
+            if(memcmp(type, "movi", 4) == 0)
+                mMoviPos = dataPos;
+        } else if(memcmp(fourcc, "idx1", 4) == 0) {
+            hasIndex = true;
+            for(unsigned int i = 0; i < size / 16; ++i) {
+                char chunkId[4];
+                mFile.read(chunkId, 4);
+                unsigned int flags = read32();
+                IndexEntry entry;
+                entry.mOffset = read32();
+                entry.mSize = read32();
+                entry.mIsKeyframe = (flags & AVIIF_KEYFRAME) != 0;
+
+                // Keep compressed ('dc') and uncompressed ('db') frames of stream 00
+                if(memcmp(chunkId, "00d", 3) == 0)
+                    mIndex.push_back(entry);
+            }
+        }
+
+        // Chunks are aligned on 16 bits
+        mFile.seekg(dataPos + size + (size % 2));
+    }
+
+    if(mMoviPos == 0 || !hasIndex) {
+        Engine::throwError(L"AVI input file has no frame list or no index");
+    }
+
+    // Offsets are usually relative to the 'movi' list, but some writers use absolute positions
+    if(!mIndex.empty() && mIndex.front().mOffset < mMoviPos) {
+        for(auto& entry : mIndex)
+            entry.mOffset += mMoviPos;
+    }
+
+    mFile.clear();
+}
+
+int AviReader::getFrameCount() const
+{
+    return mIndex.size();
+}
+
+void AviReader::readFrame(int index, std::vector<unsigned char>& data, bool& isKeyframe)
+{
+    auto& entry = mIndex.at(index);
+
+    // Skip chunk identifier and size
+    mFile.seekg(entry.mOffset + 8);
+    data.resize(entry.mSize);
+    mFile.read((char*) data.data(), entry.mSize);
+    if(!mFile.good()) {
+        Engine::throwError(L"AVI frame could not be read");
+    }
+
+    isKeyframe = entry.mIsKeyframe;
+}
+
+unsigned int AviReader::read32()
+{
+    unsigned char bytes[4] = { 0, 0, 0, 0 };
+    mFile.read((char*) bytes, 4);
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((unsigned int) bytes[3] << 24);
+}
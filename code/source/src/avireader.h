@@ -0,0 +1,73 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AVIREADER_H
+#define AVIREADER_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+/**
+ * @brief Reads the compressed frames of the first video stream of an AVI file
+ *
+ * Frames are located with the 'idx1' index, so only complete AVI files can be read. Frames are not
+ * decoded, which allows to remux them into another file.
+ */
+class AviReader
+{
+
+public:
+
+    /**
+     * Opens the file and reads its index
+     * @param fileName path to the AVI file
+     */
+    explicit AviReader(const std::string& fileName);
+
+    /**
+     * Returns number of video frames
+     * @return number of frames
+     */
+    int getFrameCount() const;
+
+    /**
+     * Reads a compressed frame
+     * @param index index of the frame in the stream
+     * @param data receives the compressed frame
+     * @param isKeyframe set to true if the frame is a keyframe
+     */
+    void readFrame(int index, std::vector<unsigned char>& data, bool& isKeyframe);
+
+private:
+
+    struct IndexEntry
+    {
+        unsigned int mOffset;
+        unsigned int mSize;
+        bool mIsKeyframe;
+    };
+
+    unsigned int read32();
+
+    std::ifstream mFile;
+    std::vector<IndexEntry> mIndex;
+    unsigned int mMoviPos;
+};
+
+#endif // AVIREADER_H
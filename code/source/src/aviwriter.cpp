@@ -0,0 +1,305 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "engine.h"
+#include "aviwriter.h"
+
+namespace
+{
+    const unsigned int AVIF_HASINDEX = 0x10;
+    const unsigned int AVIIF_KEYFRAME = 0x10;
+    const unsigned char AVI_INDEX_OF_INDEXES = 0x00;
+    const unsigned char AVI_INDEX_OF_CHUNKS = 0x01;
+    // Standard indexes flag the frames which are not keyframes with the highest bit of their size
+    const unsigned int AVISTDINDEX_DELTAFRAME = 0x80000000;
+
+    // AVI 1.0 readers need the first RIFF chunk under 1 GB, the next ones are kept as small
+    const std::streamoff MAX_RIFF_SIZE = 1 << 30;
+    // One super index entry per RIFF chunk, reserved in the header: files up to 256 GB
+    const unsigned int SUPER_INDEX_SIZE = 256;
+    const unsigned int DMLH_SIZE = 248;
+}
+
+AviWriter::AviWriter(const std::string& fileName, int width, int height, int framerate, const char* codec)
+{
+    mMaxFrameSize = 0;
+    mNbFrames = 0;
+    mNbFirstRiffFrames = 0;
+
+    mFile.open(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!mFile.is_open()) {
+        Engine::throwError(L"AVI output file cannot be opened");
+    }
+
+    // Sizes of the header lists are fixed, only the frame counts, buffer sizes and super index are patched
+    // at the end
+    const unsigned int strlSize = 4 + (8 + 56) + (8 + 40) + (8 + 24 + 16 * SUPER_INDEX_SIZE);
+    writeFourcc("RIFF");
+    mRiffSizePos = mFile.tellp();
+    write32(0);
+    writeFourcc("AVI ");
+
+    writeFourcc("LIST");
+    write32(4 + (8 + 56) + (8 + strlSize) + (8 + 4 + (8 + DMLH_SIZE)));
+    writeFourcc("hdrl");
+
+    // Main header, whose frame count only covers the first RIFF chunk as AVI 1.0 readers expect
+    writeFourcc("avih");
+    write32(56);
+    write32(1000000 / framerate);
+    write32(0);
+    write32(0);
+    write32(AVIF_HASINDEX);
+    mTotalFramesPos = mFile.tellp();
+    write32(0);
+    write32(0);
+    write32(1);
+    mMainBufferSizePos = mFile.tellp();
+    write32(0);
+    write32(width);
+    write32(height);
+    for(int i = 0; i < 4; ++i)
+        write32(0);
+
+    // Stream header
+    writeFourcc("LIST");
+    write32(strlSize);
+    writeFourcc("strl");
+
+    writeFourcc("strh");
+    write32(56);
+    writeFourcc("vids");
+    writeFourcc(codec);
+    write32(0);
+    write32(0);
+    write32(0);
+    write32(1);
+    write32(framerate);
+    write32(0);
+    mStreamLengthPos = mFile.tellp();
+    write32(0);
+    mStreamBufferSizePos = mFile.tellp();
+    write32(0);
+    write32(0xFFFFFFFF);
+    write32(0);
+    write16(0);
+    write16(0);
+    write16(width);
+    write16(height);
+
+    // Stream format (BITMAPINFOHEADER)
+    writeFourcc("strf");
+    write32(40);
+    write32(40);
+    write32(width);
+    write32(height);
+    write16(1);
+    write16(24);
+    writeFourcc(codec);
+    write32(width * height * 3);
+    for(int i = 0; i < 4; ++i)
+        write32(0);
+
+    // Super index, empty until close()
+    writeFourcc("indx");
+    write32(24 + 16 * SUPER_INDEX_SIZE);
+    mSuperIndexPos = mFile.tellp();
+    for(unsigned int i = 0; i < (24 + 16 * SUPER_INDEX_SIZE) / 4; ++i)
+        write32(0);
+
+    // OpenDML header, with the frame count of the whole file
+    writeFourcc("LIST");
+    write32(4 + (8 + DMLH_SIZE));
+    writeFourcc("odml");
+    writeFourcc("dmlh");
+    write32(DMLH_SIZE);
+    mOdmlTotalFramesPos = mFile.tellp();
+    for(unsigned int i = 0; i < DMLH_SIZE / 4; ++i)
+        write32(0);
+
+    beginMovi();
+
+    if(!mFile.good()) {
+        Engine::throwError(L"AVI headers could not be written");
+    }
+}
+
+void AviWriter::writeFrame(const unsigned char* data, int size, bool isKeyframe)
+{
+    // Frame goes to a new RIFF chunk if the current one would pass the limit with it and its indexes
+    std::streamoff chunkSize = 8 + size + size % 2;
+    std::streamoff indexSize = 32 + 8 * (mIndex.size() + 1);
+    if(mSuperIndex.empty())
+        indexSize += 8 + 16 * (mIndex.size() + 1);
+    if(!mIndex.empty() && mFile.tellp() - mRiffSizePos + chunkSize + indexSize > MAX_RIFF_SIZE) {
+        // Ending this chunk and the new one both take a super index entry
+        if(mSuperIndex.size() + 2 > SUPER_INDEX_SIZE) {
+            Engine::throwError(L"AVI file reached its maximum size");
+        }
+        endRiff();
+
+        writeFourcc("RIFF");
+        mRiffSizePos = mFile.tellp();
+        write32(0);
+        writeFourcc("AVIX");
+        beginMovi();
+    }
+
+    IndexEntry entry;
+    entry.mOffset = mFile.tellp();
+    entry.mSize = size;
+    entry.mIsKeyframe = isKeyframe;
+    mIndex.push_back(entry);
+
+    if(entry.mSize > mMaxFrameSize)
+        mMaxFrameSize = entry.mSize;
+
+    writeFourcc("00dc");
+    write32(size);
+    mFile.write((const char*) data, size);
+    // Chunks are aligned on 16 bits
+    if(size % 2 != 0)
+        mFile.put(0);
+
+    if(!mFile.good()) {
+        Engine::throwError(L"AVI frame could not be written");
+    }
+}
+
+void AviWriter::close()
+{
+    endRiff();
+
+    patch32(mTotalFramesPos, mNbFirstRiffFrames);
+    patch32(mStreamLengthPos, mNbFrames);
+    patch32(mOdmlTotalFramesPos, mNbFrames);
+    patch32(mMainBufferSizePos, mMaxFrameSize);
+    patch32(mStreamBufferSizePos, mMaxFrameSize);
+
+    // Super index lists the standard index of each RIFF chunk
+    mFile.seekp(mSuperIndexPos);
+    write16(4);
+    write8(0);
+    write8(AVI_INDEX_OF_INDEXES);
+    write32(mSuperIndex.size());
+    writeFourcc("00dc");
+    for(int i = 0; i < 3; ++i)
+        write32(0);
+    for(auto& entry : mSuperIndex) {
+        write64(entry.mOffset);
+        write32(entry.mSize);
+        write32(entry.mDuration);
+    }
+    mFile.seekp(0, std::ios::end);
+
+    if(!mFile.good()) {
+        Engine::throwError(L"AVI index could not be written");
+    }
+    mFile.close();
+}
+
+void AviWriter::beginMovi()
+{
+    writeFourcc("LIST");
+    mMoviSizePos = mFile.tellp();
+    write32(0);
+    mMoviStartPos = mFile.tellp();
+    writeFourcc("movi");
+}
+
+void AviWriter::endRiff()
+{
+    // Standard index of the frames of this chunk, at the end of its 'movi' list. Offsets are relative to
+    // the list and point to the frame data.
+    SuperIndexEntry superEntry;
+    superEntry.mOffset = mFile.tellp();
+    superEntry.mSize = 32 + 8 * mIndex.size();
+    superEntry.mDuration = mIndex.size();
+    mSuperIndex.push_back(superEntry);
+
+    std::streamoff moviStart = mMoviStartPos;
+    writeFourcc("ix00");
+    write32(24 + 8 * mIndex.size());
+    write16(2);
+    write8(0);
+    write8(AVI_INDEX_OF_CHUNKS);
+    write32(mIndex.size());
+    writeFourcc("00dc");
+    write64(moviStart);
+    write32(0);
+    for(auto& entry : mIndex) {
+        write32((unsigned int) (entry.mOffset + 8 - moviStart));
+        write32(entry.mIsKeyframe ? entry.mSize : (entry.mSize | AVISTDINDEX_DELTAFRAME));
+    }
+    patch32(mMoviSizePos, (unsigned int) (mFile.tellp() - mMoviStartPos));
+
+    // AVI 1.0 index follows the 'movi' list of the first chunk only
+    if(mSuperIndex.size() == 1) {
+        writeFourcc("idx1");
+        write32(16 * mIndex.size());
+        for(auto& entry : mIndex) {
+            writeFourcc("00dc");
+            write32(entry.mIsKeyframe ? AVIIF_KEYFRAME : 0);
+            write32((unsigned int) (entry.mOffset - moviStart));
+            write32(entry.mSize);
+        }
+        mNbFirstRiffFrames = mIndex.size();
+    }
+
+    patch32(mRiffSizePos, (unsigned int) (mFile.tellp() - mRiffSizePos) - 4);
+    mNbFrames += mIndex.size();
+    mIndex.clear();
+}
+
+void AviWriter::writeFourcc(const char* fourcc)
+{
+    mFile.write(fourcc, 4);
+}
+
+void AviWriter::write64(unsigned long long value)
+{
+    write32((unsigned int) (value & 0xFFFFFFFF));
+    write32((unsigned int) (value >> 32));
+}
+
+void AviWriter::write32(unsigned int value)
+{
+    // AVI is little-endian whatever the host is
+    char bytes[4] = { (char) (value & 0xFF), (char) ((value >> 8) & 0xFF),
+                      (char) ((value >> 16) & 0xFF), (char) ((value >> 24) & 0xFF) };
+    mFile.write(bytes, 4);
+}
+
+void AviWriter::write16(unsigned short value)
+{
+    char bytes[2] = { (char) (value & 0xFF), (char) ((value >> 8) & 0xFF) };
+    mFile.write(bytes, 2);
+}
+
+void AviWriter::write8(unsigned char value)
+{
+    mFile.put((char) value);
+}
+
+void AviWriter::patch32(std::streampos position, unsigned int value)
+{
+    std::streampos current = mFile.tellp();
+    mFile.seekp(position);
+    write32(value);
+    mFile.seekp(current);
+}
@@ -0,0 +1,110 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AVIWRITER_H
+#define AVIWRITER_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+/**
+ * @brief Writes an AVI file made of a single compressed video stream
+ *
+ * Frames are appended to the 'movi' list as they come. The file follows OpenDML (AVI 2.0), so that long
+ * recordings are not limited to 4 GB: it is split into RIFF chunks of at most 1 GB, each ending with a
+ * standard index of its frames, and a super index in the stream header lists these indexes. The first RIFF
+ * chunk also has an AVI 1.0 index, so that older readers play its frames. Indexes and frame counts are
+ * written by close(), so the file is only playable once it has been called.
+ */
+class AviWriter
+{
+
+public:
+
+    /**
+     * Opens the file and writes the headers
+     * @param fileName path to the AVI file to create
+     * @param width frame width
+     * @param height frame height
+     * @param framerate frame rate of the video
+     * @param codec four character code of the compressed stream (e.g. "XVID")
+     */
+    AviWriter(const std::string& fileName, int width, int height, int framerate, const char* codec);
+
+    /**
+     * Appends a compressed frame to the stream, in a new RIFF chunk if the current one is full
+     * @param data compressed frame
+     * @param size size of compressed frame in bytes
+     * @param isKeyframe true if the frame can be decoded on its own
+     */
+    void writeFrame(const unsigned char* data, int size, bool isKeyframe);
+
+    /**
+     * Writes the indexes and completes the headers
+     */
+    void close();
+
+private:
+
+    struct IndexEntry
+    {
+        std::streamoff mOffset;
+        unsigned int mSize;
+        bool mIsKeyframe;
+    };
+
+    struct SuperIndexEntry
+    {
+        std::streamoff mOffset;
+        unsigned int mSize;
+        unsigned int mDuration;
+    };
+
+    void beginMovi();
+    void endRiff();
+
+    void writeFourcc(const char* fourcc);
+    void write64(unsigned long long value);
+    void write32(unsigned int value);
+    void write16(unsigned short value);
+    void write8(unsigned char value);
+    void patch32(std::streampos position, unsigned int value);
+
+    std::ofstream mFile;
+    // Frames of the current RIFF chunk
+    std::vector<IndexEntry> mIndex;
+    std::vector<SuperIndexEntry> mSuperIndex;
+    unsigned int mMaxFrameSize;
+    unsigned int mNbFrames;
+    unsigned int mNbFirstRiffFrames;
+
+    std::streampos mTotalFramesPos;
+    std::streampos mMainBufferSizePos;
+    std::streampos mStreamLengthPos;
+    std::streampos mStreamBufferSizePos;
+    std::streampos mSuperIndexPos;
+    std::streampos mOdmlTotalFramesPos;
+
+    // Current RIFF chunk
+    std::streampos mRiffSizePos;
+    std::streampos mMoviSizePos;
+    std::streampos mMoviStartPos;
+};
+
+#endif // AVIWRITER_H
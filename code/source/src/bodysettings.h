@@ -40,6 +40,11 @@ public:
         mTrajVisible = false;
         mTrajColor = SColor(0, 0, 0, 0);
         mTrajNbPoints = 0;
+        mTrajFade = false;
+        mLodModelPath = "";
+        mLodSize = 0;
+        mBillboardPath = "";
+        mBillboardSize = 0;
     }
 
     /**
@@ -75,6 +80,31 @@ public:
      * Number of points forming trajectory color curve
      */
     int mTrajNbPoints;
+
+    /**
+     * Whether trajectory color curve fades out towards its oldest point
+     */
+    bool mTrajFade;
+
+    /**
+     * Path to decimated 3D model with the same animation, or empty path if there is none
+     */
+    io::path mLodModelPath;
+
+    /**
+     * Height on screen in pixels under which the decimated model is displayed
+     */
+    float mLodSize;
+
+    /**
+     * Path to billboard texture displayed instead of distant models, or empty path if there is none
+     */
+    io::path mBillboardPath;
+
+    /**
+     * Height on screen in pixels under which the billboard is displayed
+     */
+    float mBillboardSize;
 };
 
 #endif // BODYSETTINGS_H
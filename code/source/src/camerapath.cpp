@@ -0,0 +1,122 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <iterator>
+#include "camerapath.h"
+
+CameraPath::CameraPath()
+{
+
+}
+
+void CameraPath::addKeyframe(int frame, const vector3df& position, const vector3df& rotation)
+{
+    Keyframe keyframe = { position, rotation };
+    mKeyframes[frame] = keyframe;
+}
+
+const vector3df CameraPath::getPosition(double time) const
+{
+    if(mKeyframes.empty())
+        return vector3df(0, 0, 0);
+
+    KeyframeIterator k[4];
+    findSegment(time, k);
+
+    vector3df p[4];
+    double t[4];
+    for(int i = 0; i < 4; ++i) {
+        p[i] = k[i]->second.mPosition;
+        t[i] = k[i]->first;
+    }
+    return interpolate(p, t, time);
+}
+
+const vector3df CameraPath::getRotation(double time) const
+{
+    if(mKeyframes.empty())
+        return vector3df(0, 0, 0);
+
+    KeyframeIterator k[4];
+    findSegment(time, k);
+
+    // Angles are unwrapped from the rotation of the segment start, so that the spline never spins the long way
+    vector3df p[4];
+    double t[4];
+    p[1] = k[1]->second.mRotation;
+    p[0] = p[1] + getShortestDelta(k[0]->second.mRotation, k[1]->second.mRotation);
+    p[2] = p[1] + getShortestDelta(k[2]->second.mRotation, k[1]->second.mRotation);
+    p[3] = p[2] + getShortestDelta(k[3]->second.mRotation, k[2]->second.mRotation);
+    for(int i = 0; i < 4; ++i)
+        t[i] = k[i]->first;
+
+    return interpolate(p, t, time);
+}
+
+unsigned int CameraPath::getKeyframeCount() const
+{
+    return mKeyframes.size();
+}
+
+void CameraPath::findSegment(double time, KeyframeIterator k[4]) const
+{
+    // First keyframe after the time, whose predecessor starts the segment
+    auto next = mKeyframes.upper_bound((int) std::floor(time));
+    if(next == mKeyframes.begin()) {
+        k[0] = k[1] = k[2] = k[3] = next;
+        return;
+    }
+
+    k[1] = std::prev(next);
+    k[0] = (k[1] == mKeyframes.begin()) ? k[1] : std::prev(k[1]);
+    if(next == mKeyframes.end()) {
+        k[2] = k[3] = k[1];
+        return;
+    }
+    k[2] = next;
+    k[3] = (std::next(next) == mKeyframes.end()) ? next : std::next(next);
+}
+
+vector3df CameraPath::interpolate(const vector3df p[4], const double t[4], double time)
+{
+    double length = t[2] - t[1];
+    if(length <= 0)
+        return p[1];
+
+    // Tangents are scaled to the length of the segment, for keyframes unevenly spaced
+    vector3df m1 = (p[2] - p[0]) * (float) (length / (t[2] - t[0]));
+    vector3df m2 = (p[3] - p[1]) * (float) (length / (t[3] - t[1]));
+
+    float s = (float) ((time - t[1]) / length);
+    float s2 = s * s;
+    float s3 = s2 * s;
+    return p[1] * (2 * s3 - 3 * s2 + 1)
+            + m1 * (s3 - 2 * s2 + s)
+            + p[2] * (-2 * s3 + 3 * s2)
+            + m2 * (s3 - s2);
+}
+
+vector3df CameraPath::getShortestDelta(const vector3df& to, const vector3df& from)
+{
+    vector3df delta = to - from;
+    delta.X = (float) (std::fmod(std::fmod(delta.X + 180.0, 360.0) + 360.0, 360.0) - 180.0);
+    delta.Y = (float) (std::fmod(std::fmod(delta.Y + 180.0, 360.0) + 360.0, 360.0) - 180.0);
+    delta.Z = (float) (std::fmod(std::fmod(delta.Z + 180.0, 360.0) + 360.0, 360.0) - 180.0);
+    return delta;
+}
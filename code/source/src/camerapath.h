@@ -0,0 +1,111 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CAMERAPATH_H
+#define CAMERAPATH_H
+
+#include <map>
+#include <irrlicht.h>
+
+using namespace irr::core;
+
+/**
+ * @brief Camera trajectory made of keyframes
+ *
+ * Per-frame camera files give a pose for every frame of the sequence. A keyframed file only gives the poses
+ * of a few frames, and the poses in between are computed on demand on a Catmull-Rom spline going through the
+ * keyframes. Keyframes may be unevenly spaced: the tangent at a keyframe is the slope between its neighbours.
+ * Before the first keyframe and after the last one, the camera stays at the pose of the nearest keyframe.
+ */
+class CameraPath
+{
+
+public:
+
+    /**
+     * Creates a path without keyframes
+     */
+    CameraPath();
+
+    /**
+     * Adds a keyframe, or replaces the one of the same frame
+     * @param frame frame index
+     * @param position virtual position of the camera
+     * @param rotation rotation of the camera in degrees
+     */
+    void addKeyframe(int frame, const vector3df& position, const vector3df& rotation);
+
+    /**
+     * Returns position of the camera at the given time
+     * @param time frame index, possibly fractional
+     * @return virtual position
+     */
+    const vector3df getPosition(double time) const;
+
+    /**
+     * Returns rotation of the camera at the given time. Angles turn the shortest way between two keyframes.
+     * @param time frame index, possibly fractional
+     * @return rotation in degrees
+     */
+    const vector3df getRotation(double time) const;
+
+    /**
+     * Returns number of keyframes
+     * @return number of keyframes
+     */
+    unsigned int getKeyframeCount() const;
+
+private:
+
+    struct Keyframe
+    {
+        vector3df mPosition;
+        vector3df mRotation;
+    };
+
+    typedef std::map<int, Keyframe>::const_iterator KeyframeIterator;
+
+    /**
+     * Finds the four keyframes around a time: the two surrounding it, and their outer neighbours. At both ends
+     * of the path, missing neighbours are replaced by the nearest keyframe.
+     * @param time frame index
+     * @param k keyframes to fill, in time order
+     */
+    void findSegment(double time, KeyframeIterator k[4]) const;
+
+    /**
+     * Evaluates the spline between p1 and p2 with a cubic Hermite curve
+     * @param p values of the four keyframes
+     * @param t frame indexes of the four keyframes
+     * @param time frame index, between t[1] and t[2]
+     * @return interpolated value
+     */
+    static vector3df interpolate(const vector3df p[4], const double t[4], double time);
+
+    /**
+     * Returns the difference between two rotations, with each angle brought back to [-180, 180)
+     * @param to rotation in degrees
+     * @param from rotation in degrees
+     * @return shortest difference
+     */
+    static vector3df getShortestDelta(const vector3df& to, const vector3df& from);
+
+    std::map<int, Keyframe> mKeyframes;
+};
+
+#endif // CAMERAPATH_H
@@ -47,8 +47,12 @@ public:
         mFontJerseyPath = "";
         mFpsScale = 0.0;
         mFieldOfView = 0.0;
+        mKeyframes = false;
         mDisplayAxes = false;
         mFullScreen = false;
+        mOcclusionQueries = false;
+        mDisplayProfile = false;
+        mFrameCacheSize = 256;
     }
 
     /**
@@ -97,6 +101,11 @@ public:
      */
     float mFieldOfView;
 
+    /**
+     * Specifies whether the camera trajectory file only gives keyframes, joined by a spline
+     */
+    bool mKeyframes;
+
     /**
      * Specifies whether virtual Irrlicht axes have to be displayed
      */
@@ -106,6 +115,21 @@ public:
      * Specifies whether fullscreen is enabled for Irrlicht window
      */
     bool mFullScreen;
+
+    /**
+     * Specifies whether bodies hidden behind others in the previous frame of the main camera are skipped
+     */
+    bool mOcclusionQueries;
+
+    /**
+     * Specifies whether the durations of the frame stages are displayed below the frame count
+     */
+    bool mDisplayProfile;
+
+    /**
+     * Specifies the memory (in megabytes) for the images kept to scrub the timeline, 0 to disable it
+     */
+    int mFrameCacheSize;
 };
 
 #endif // CAMERASETTINGS_H
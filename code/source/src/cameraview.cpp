@@ -0,0 +1,68 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "engine.h"
+#include "cameraview.h"
+
+CameraView::CameraView(Engine& engine, const ViewSettings& viewSettings) : Moveable(engine)
+{
+    mSettings = viewSettings;
+
+    // Same camera setup as the main camera of the window, but the active camera does not change
+    auto sceneManager = engine.getCameraWindow().getSceneManager();
+    mCamera = sceneManager->addCameraSceneNode(nullptr, vector3df(0, 0, 0), vector3df(0, 0, 100), -1, false);
+
+    mCamera->bindTargetAndRotation(true);
+    mCamera->setFarValue(30000);
+    mCamera->setFOV(mSettings.mFieldOfView);
+}
+
+CameraView::~CameraView()
+{
+    mCamera->remove();
+}
+
+void CameraView::setTime(int time)
+{
+    mCamera->setPosition(mPath ? mPath->getPosition(time) : getPosition(time));
+    // setTarget uses absolute position member so we need to update it every time position is changed
+    mCamera->updateAbsolutePosition();
+    mCamera->setRotation(mPath ? mPath->getRotation(time) : getRotation(time));
+}
+
+void CameraView::setInterpolatedTime(double time)
+{
+    mCamera->setPosition(mPath ? mPath->getPosition(time) : getInterpolatedPosition(time));
+    mCamera->updateAbsolutePosition();
+    mCamera->setRotation(mPath ? mPath->getRotation(time) : getInterpolatedRotation(time));
+}
+
+void CameraView::setPath(std::unique_ptr<CameraPath> path)
+{
+    mPath = std::move(path);
+}
+
+ICameraSceneNode* CameraView::getCamera() const
+{
+    return mCamera;
+}
+
+const ViewSettings& CameraView::getSettings() const
+{
+    return mSettings;
+}
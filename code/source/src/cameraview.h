@@ -0,0 +1,97 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CAMERAVIEW_H
+#define CAMERAVIEW_H
+
+#include <irrlicht.h>
+#include "moveable.h"
+#include "viewsettings.h"
+#include "camerapath.h"
+
+using namespace irr;
+using namespace irr::core;
+using namespace irr::scene;
+
+/**
+ * @brief Additional camera of the window
+ *
+ * Camera following its own trajectory file, recorded to its own output besides the main camera of CameraWindow.
+ * The scene is not updated by the view: the court is moved once per frame, then the window draws it once for
+ * each camera.
+ * @see CameraWindow::updateScene()
+ */
+class CameraView : public Moveable
+{
+
+public:
+
+    /**
+     * Adds the camera to the scene of the engine window, without making it active
+     * @param engine engine whose window displays the view
+     * @param viewSettings settings of the view
+     */
+    CameraView(Engine& engine, const ViewSettings& viewSettings);
+
+    /**
+     * Removes the camera from the scene
+     */
+    virtual ~CameraView();
+
+    /**
+     * Moves the camera to the position and rotation of its trajectory at the given time
+     * @param time frame index
+     */
+    virtual void setTime(int time) override;
+
+    /**
+     * Moves the camera between the poses of two frames of its trajectory
+     * @param time fractional frame index
+     */
+    void setInterpolatedTime(double time);
+
+    /**
+     * Makes the camera follow a keyframed path instead of its per-frame trajectory
+     * @param path keyframed path
+     */
+    void setPath(std::unique_ptr<CameraPath> path);
+
+    /**
+     * Returns Irrlicht camera of the view
+     * @return camera node
+     */
+    ICameraSceneNode* getCamera() const;
+
+    /**
+     * Returns view settings
+     * @return view settings
+     */
+    const ViewSettings& getSettings() const;
+
+private:
+
+    CameraView(const CameraView&) = delete;
+    CameraView& operator=(const CameraView&) = delete;
+
+    ViewSettings mSettings;
+    ICameraSceneNode* mCamera;
+    // Keyframed trajectory, replacing the per-frame one if set
+    std::unique_ptr<CameraPath> mPath;
+};
+
+#endif // CAMERAVIEW_H
@@ -17,10 +17,14 @@
  */
 
 #include <iostream>
+#include <cstdio>
+#include <cmath>
 #include <QTime>
 
 #include "engine.h"
 #include "camerawindow.h"
+#include "frameprofiler.h"
+#include "tracerecorder.h"
 
 using namespace irr;
 using namespace irr::core;
@@ -29,7 +33,7 @@ using namespace irr::scene;
 using namespace irr::video;
 
 
-CameraWindow::CameraWindow(const CameraSettings& cameraSettings) : Moveable()
+CameraWindow::CameraWindow(Engine& engine, const CameraSettings& cameraSettings) : Moveable(engine)
 {
     this->mSettings = cameraSettings;
 
@@ -83,22 +87,12 @@ CameraWindow::CameraWindow(const CameraSettings& cameraSettings) : Moveable()
     mStaticCamera->setFOV(mSettings.mFieldOfView);
 
     // Create event manager to handle keyboard and mouse inputs from Irrlicht
-    mEventManager = std::unique_ptr<EventManager>(new EventManager());
+    mEventManager = std::unique_ptr<EventManager>(new EventManager(engine));
     mDevice->setEventReceiver(mEventManager.get());
 
-    Engine& engine = Engine::getInstance();
-
     // Create GUI environment to use fonts and display 2D texts
     mGui = mDevice->getGUIEnvironment();
-    mGuiFont = mGui->getFont(mSettings.mFontGUIPath);
-    if(mGuiFont == nullptr) {
-        engine.throwError(L"Gui font could not be loaded");
-    }
-    mJerseyFont = mGui->getFont(mSettings.mFontJerseyPath);
-    if(mJerseyFont == nullptr) {
-        engine.throwError(L"Jersey font could not be loaded");
-    }
-    mJerseyFont->setKerningWidth(50);
+    loadFonts();
 
     // Set default font
     auto skin = mGui->getSkin();
@@ -109,22 +103,79 @@ CameraWindow::CameraWindow(const CameraSettings& cameraSettings) : Moveable()
     stringw initialFrameText("Frame count");
     mFrameCount = mGui->addStaticText(initialFrameText.c_str(), recti(0, 0, dimension.Width, dimension.Height));
     mFrameCount->setOverrideColor(SColor(255, 255, 255, 255));
+    mDisplayedFrame = -1;
+
+    // Optional stage durations below the frame count
+    mProfileText = mGui->addStaticText(L"", recti(0, dimension.Height, dimension.Width, dimension.Height * 9));
+    mProfileText->setOverrideColor(SColor(255, 255, 255, 255));
+    mProfileText->setVisible(false);
+
+    // Scrubbing cache, whose texture is created on the first image shown again
+    mFrameCache = std::unique_ptr<FrameCache>(new FrameCache((u32) mSettings.mFrameCacheSize * 1024 * 1024));
+    mCacheTexture = nullptr;
+    mIsBetweenFrames = false;
+
+    // Nothing has been displayed yet
+    mIsSceneDirty = true;
+    mIsCameraDirty = true;
+    mIsOverlayDirty = true;
 }
 
 
+void CameraWindow::loadFonts()
+{
+    mGuiFont = mGui->getFont(mSettings.mFontGUIPath);
+    if(mGuiFont == nullptr) {
+        Engine::throwError(L"Gui font could not be loaded");
+    }
+    mJerseyFont = mGui->getFont(mSettings.mFontJerseyPath);
+    if(mJerseyFont == nullptr) {
+        Engine::throwError(L"Jersey font could not be loaded");
+    }
+    mJerseyFont->setKerningWidth(50);
+}
+
 CameraWindow::~CameraWindow()
 {
+    if(mCacheTexture != nullptr)
+        mDriver->removeTexture(mCacheTexture);
     mDevice->drop();
 }
 
+bool CameraWindow::isCompatible(const CameraSettings& cameraSettings) const
+{
+    return cameraSettings.mWindowSize == mSettings.mWindowSize
+            && cameraSettings.mFullScreen == mSettings.mFullScreen;
+}
+
+void CameraWindow::resetSettings(const CameraSettings& cameraSettings)
+{
+    mSettings = cameraSettings;
+
+    clearTrajectories();
+    mPath.reset();
+    mStaticCamera->setFOV(mSettings.mFieldOfView);
+
+    // Fonts already used by previous configurations come from the GUI cache
+    loadFonts();
+    mGui->getSkin()->setFont(mGuiFont);
+
+    // The new configuration shows another scene, even if frame and camera are the same
+    mFrameCache = std::unique_ptr<FrameCache>(new FrameCache((u32) mSettings.mFrameCacheSize * 1024 * 1024));
+    mDisplayedFrame = -1;
+    mIsSceneDirty = true;
+    mIsCameraDirty = true;
+    mIsOverlayDirty = true;
+}
+
 vector3df CameraWindow::getRealPosition() const
 {
-    return Engine::getInstance().getAffineTransformation().convertToReal(mStaticCamera->getPosition());
+    return mEngine.getAffineTransformation().convertToReal(mStaticCamera->getPosition());
 }
 
 void CameraWindow::setRealPosition(const vector3df &position)
 {
-    setVirtualPosition(Engine::getInstance().getAffineTransformation().convertToVirtual(position));
+    setVirtualPosition(mEngine.getAffineTransformation().convertToVirtual(position));
 }
 
 void CameraWindow::setVirtualPosition(const vector3df& virtualPosition)
@@ -135,6 +186,7 @@ void CameraWindow::setVirtualPosition(const vector3df& virtualPosition)
     mStaticCamera->updateAbsolutePosition();
     // Call setRotation to trigger setTarget
     mStaticCamera->setRotation(rotation);
+    mIsCameraDirty = true;
 }
 
 
@@ -170,6 +222,7 @@ void CameraWindow::moveVirtual(const vector3df& moveVector)
     target += pos;
 
     mStaticCamera->setTarget(target);
+    mIsCameraDirty = true;
 }
 
 const vector3df& CameraWindow::getRotation() const
@@ -180,6 +233,7 @@ const vector3df& CameraWindow::getRotation() const
 void CameraWindow::setRotation(const vector3df& rotation)
 {
     mStaticCamera->setRotation(rotation);
+    mIsCameraDirty = true;
 }
 
 void CameraWindow::rotate(const vector3df& rotationVector)
@@ -206,48 +260,36 @@ void CameraWindow::rotate(const vector3df& rotationVector)
     target += mStaticCamera->getPosition();
 
     mStaticCamera->setTarget(target);
+    mIsCameraDirty = true;
 }
 
 void CameraWindow::updateScene()
 {
+    updateScene(mStaticCamera);
+}
+
+void CameraWindow::updateScene(ICameraSceneNode* camera)
+{
+    TraceRecorder::Span span("render");
+    mSceneManager->setActiveCamera(camera);
+
     mDriver->beginScene(
                 true, // clear back-buffer
                 true, // clear z-buffer
                 mSettings.mBgColor);
 
-    Engine& engine = Engine::getInstance();
-    static bool areJerseyNumbersGiven = false;
-
-    if(!areJerseyNumbersGiven) {
-        const PlayerMap& players = engine.getCourt().getPlayers();
-        // Render jersey number on player texture
-        for(auto i = players.begin(); i != players.end(); ++i) {
-            Player& plr = *i->second;
-
-            // Virtual surface where to draw
-            auto renderTexture = plr.getRenderTexture();
-            // Actual player texture with its color but without jersey number
-            auto texture = plr.getTexture();
-            // Now we draw on texture instead of window
-            mDriver->setRenderTarget(renderTexture);
-
-            // Draw actual player texture
-            mDriver->setMaterial(mDriver->getMaterial2D());
-            mDriver->draw2DImage(texture, vector2di(0, 0));
-
-            // Draw jersey number over it
-            mDriver->setMaterial(mDriver->getMaterial2D());
-            mJerseyFont->draw(plr.getJerseyText(),
-                              plr.getPlayerSettings().mJerseyTextRect,
-                              mSettings.mJerseyTextColor, true, true);
-
-            // We go back to window (necessary to be able to switch, see API)
-            mDriver->setRenderTarget(0, true, true, mSettings.mBgColor);
-        }
-        areJerseyNumbersGiven = true;
+    // Results of the previous image decide which bodies are drawn, then bodies are tested on this one
+    bool isOcclusionTested = mSettings.mOcclusionQueries && camera == mStaticCamera;
+    if(isOcclusionTested)
+        mDriver->updateAllOcclusionQueries(false);
+
+    {
+        FrameProfiler::ScopedTimer timer(FrameProfiler::STAGE_DRAW);
+        mSceneManager->drawAll();
     }
 
-    mSceneManager->drawAll();
+    if(isOcclusionTested)
+        mDriver->runAllOcclusionQueries(false);
 
     if(mSettings.mDisplayAxes) {
         float scaleAxes = 100;
@@ -270,11 +312,105 @@ void CameraWindow::updateScene()
 //        driver->draw3DLine(convertToVirtual(posBegin),
 //                      convertToVirtual(posEnd), SColor(255, 0, 255, 0));
 
+    // Profile shows the durations of the previous frames of the main camera
+    mProfileText->setVisible(mSettings.mDisplayProfile && camera == mStaticCamera);
+    if(mSettings.mDisplayProfile && camera == mStaticCamera)
+        updateProfileText();
+
     // Solve another OpenGL issue by resetting material
     mDriver->setMaterial(mDriver->getMaterial2D());
-    mGui->drawAll();
+    {
+        FrameProfiler::ScopedTimer timer(FrameProfiler::STAGE_GUI);
+        mGui->drawAll();
+    }
+
+    mDriver->endScene();
+
+    mSceneManager->setActiveCamera(mStaticCamera);
+
+    // The window shows the main camera again only if it was the one used
+    bool isMainCamera = (camera == mStaticCamera);
+    mIsSceneDirty = !isMainCamera;
+    mIsCameraDirty = !isMainCamera;
+    mIsOverlayDirty = !isMainCamera;
+}
+
+bool CameraWindow::redraw()
+{
+    if(!isDirty())
+        return false;
+
+    updateScene();
+    return true;
+}
+
+bool CameraWindow::redrawCached()
+{
+    if(!isDirty())
+        return false;
+
+    // Images of a scene between two frames cannot be found again, and the profile changes on every image
+    if(mSettings.mFrameCacheSize == 0 || mSettings.mDisplayProfile || mIsBetweenFrames || mDisplayedFrame < 0) {
+        updateScene();
+        return true;
+    }
+
+    auto position = mStaticCamera->getPosition();
+    auto rotation = getRotation();
+    IImage* image = mFrameCache->get(mDisplayedFrame, position, rotation);
+    if(image != nullptr && displayCachedImage(image)) {
+        mIsSceneDirty = false;
+        mIsCameraDirty = false;
+        mIsOverlayDirty = false;
+        return true;
+    }
 
+    updateScene();
+    image = createScreenshot();
+    mFrameCache->insert(mDisplayedFrame, position, rotation, image);
+    image->drop();
+    return true;
+}
+
+void CameraWindow::clearFrameCache()
+{
+    mFrameCache->clear();
+}
+
+bool CameraWindow::displayCachedImage(IImage* image)
+{
+    if(mCacheTexture == nullptr) {
+        // Texture is drawn at its own size, so mipmaps would only take memory
+        bool isMipMapped = mDriver->getTextureCreationFlag(ETCF_CREATE_MIP_MAPS);
+        mDriver->setTextureCreationFlag(ETCF_CREATE_MIP_MAPS, false);
+        mCacheTexture = mDriver->addTexture(mSettings.mWindowSize, "frame cache", ECF_A8R8G8B8);
+        mDriver->setTextureCreationFlag(ETCF_CREATE_MIP_MAPS, isMipMapped);
+        if(mCacheTexture == nullptr)
+            return false;
+    }
+
+    // Texture may be larger than the window if the driver needs power of two sizes, so the image is copied
+    // unscaled in its upper left corner, row by row with the pitch of the texture
+    auto size = image->getDimension();
+    image->copyToScaling(mCacheTexture->lock(ETLM_WRITE_ONLY), size.Width, size.Height,
+                         mCacheTexture->getColorFormat(), mCacheTexture->getPitch());
+    mCacheTexture->unlock();
+
+    // Only the part of the texture holding the image is drawn
+    mDriver->beginScene(true, true, mSettings.mBgColor);
+    mDriver->draw2DImage(mCacheTexture, position2di(0, 0), recti(position2di(0, 0), mSettings.mWindowSize));
     mDriver->endScene();
+    return true;
+}
+
+bool CameraWindow::isDirty() const
+{
+    return mIsSceneDirty || mIsCameraDirty || mIsOverlayDirty;
+}
+
+void CameraWindow::invalidateScene()
+{
+    mIsSceneDirty = true;
 }
 
 IrrlichtDevice* CameraWindow::getDevice() const
@@ -292,19 +428,75 @@ IVideoDriver* CameraWindow::getDriver() const
     return mDriver;
 }
 
+ICameraSceneNode* CameraWindow::getCamera() const
+{
+    return mStaticCamera;
+}
+
 IImage* CameraWindow::createScreenshot() const
 {
     auto screenshot = mDriver->createScreenShot();
     return screenshot;
 }
 
+void CameraWindow::captureFrame(YuvConverter& converter)
+{
+    IImage* image;
+    {
+        FrameProfiler::ScopedTimer timer(FrameProfiler::STAGE_READBACK);
+        TraceRecorder::Span span("readback");
+        image = createScreenshot();
+    }
+
+    FrameProfiler::ScopedTimer timer(FrameProfiler::STAGE_CONVERSION);
+    if(image->getColorFormat() == ECF_A8R8G8B8) {
+        // A8R8G8B8 is stored as BGRA in memory, so pixels can be read directly
+        converter.convert((const unsigned char*) image->lock(), image->getPitch());
+        image->unlock();
+    } else {
+        u32 width = converter.getWidth();
+        u32 height = converter.getHeight();
+        mCaptureBuffer.resize(width * height * 4);
+        image->copyToScaling(mCaptureBuffer.data(), width, height, ECF_A8R8G8B8);
+        converter.convert(mCaptureBuffer.data(), width * 4);
+    }
+
+    // Drop Irrlicht resource after its process
+    image->drop();
+}
+
 void CameraWindow::setFrameCount(int frameCountNew)
 {
+    if(frameCountNew == mDisplayedFrame)
+        return;
+
+    mDisplayedFrame = frameCountNew;
+    mIsOverlayDirty = true;
     mFrameText = stringw("");
     mFrameText += frameCountNew;
     mFrameCount->setText(mFrameText.c_str());
 }
 
+void CameraWindow::updateProfileText()
+{
+    // A few seconds of playback, so that the figures stay readable
+    const unsigned int nbRecentFrames = 100;
+
+    stringw text;
+    for(int stage = 0; stage < FrameProfiler::STAGE_COUNT; ++stage) {
+        auto stats = FrameProfiler::computeRecentStatistics((FrameProfiler::Stage) stage, nbRecentFrames);
+        if(stats.mCount == 0)
+            continue;
+
+        char line[128];
+        snprintf(line, sizeof(line), "%-10s p50 %6.2f  p95 %6.2f  p99 %6.2f  max %6.2f ms\n",
+                 FrameProfiler::getStageName((FrameProfiler::Stage) stage),
+                 stats.mMedian, stats.mP95, stats.mP99, stats.mMax);
+        text += line;
+    }
+    mProfileText->setText(text.c_str());
+}
+
 void CameraWindow::takeScreenshot(int systemTime)
 {
     stringw str = "screenshot_";
@@ -321,19 +513,41 @@ IGUIFont* CameraWindow::getJerseyFont() const
 
 void CameraWindow::setTime(int time)
 {
+    mIsBetweenFrames = false;
     if(mSettings.mFollowTrajectoryFile) {
-        setVirtualPosition(Moveable::getPosition(time));
-        setRotation(Moveable::getRotation(time));
+        // Camera is only moved if the trajectory gives another pose
+        auto position = mPath ? mPath->getPosition(time) : Moveable::getPosition(time);
+        auto rotation = mPath ? mPath->getRotation(time) : Moveable::getRotation(time);
+        if(position != mStaticCamera->getPosition() || rotation != getRotation()) {
+            setVirtualPosition(position);
+            setRotation(rotation);
+        }
     }
 
     setFrameCount(time);
 }
 
+void CameraWindow::setInterpolatedTime(double time)
+{
+    mIsBetweenFrames = true;
+    if(mSettings.mFollowTrajectoryFile) {
+        setVirtualPosition(mPath ? mPath->getPosition(time) : getInterpolatedPosition(time));
+        setRotation(mPath ? mPath->getRotation(time) : getInterpolatedRotation(time));
+    }
+
+    setFrameCount((int) std::floor(time));
+}
+
 const CameraSettings &CameraWindow::getSettings() const
 {
     return mSettings;
 }
 
+void CameraWindow::setPath(std::unique_ptr<CameraPath> path)
+{
+    mPath = std::move(path);
+}
+
 void CameraWindow::setFollowTrajectoryFile(bool isFollowingTrajectoryFile)
 {
     mSettings.mFollowTrajectoryFile = isFollowingTrajectoryFile;
@@ -25,6 +25,9 @@
 #include "eventmanager.h"
 #include "camerasettings.h"
 #include "moveable.h"
+#include "yuvconverter.h"
+#include "framecache.h"
+#include "camerapath.h"
 
 using namespace irr;
 using namespace irr::core;
@@ -33,12 +36,13 @@ using namespace irr::scene;
 using namespace irr::video;
 
 class EventManager;
+class Engine;
 
 /**
  * @brief Irrlicht window singleton
  *
- * Represents Irrlicht window. You must call constructCamera() in AvatarsFactory before using getInstance().
- * @see AvatarsFactory::constructCamera()
+ * Represents Irrlicht window. It is created by AvatarsFactory::createCamera() for an engine.
+ * @see AvatarsFactory::createCamera()
  */
 class CameraWindow : public Moveable
 {
@@ -47,9 +51,10 @@ public:
 
     /**
      * Constructs 3D view
+     * @param engine engine displayed by the view
      * @param cameraSettings camera settings
      */
-    explicit CameraWindow(const CameraSettings& cameraSettings);
+    CameraWindow(Engine& engine, const CameraSettings& cameraSettings);
 
     /**
      * Destroys Irrlicht view and event manager
@@ -57,11 +62,68 @@ public:
     virtual ~CameraWindow();
 
     /**
-     * Displays current scene in the window. Draws the scene background, then the players with the jersey number
-     * printed on their texture, then the axes (if settings allow it), then the frame index in top-left corner
+     * Tells whether the window can be reused with other settings. The Irrlicht device is created with the window
+     * size and fullscreen mode, which therefore cannot change.
+     * @param cameraSettings settings of the new configuration
+     * @return true if the device is compatible with the settings
+     */
+    bool isCompatible(const CameraSettings& cameraSettings) const;
+
+    /**
+     * Applies the settings of another configuration to a compatible window, and forgets the camera trajectory.
+     * The device is kept with its mesh, texture and font caches.
+     * @param cameraSettings settings of the new configuration
+     * @see isCompatible()
+     */
+    void resetSettings(const CameraSettings& cameraSettings);
+
+    /**
+     * Displays current scene in the window. Draws the scene background and the bodies, then the axes (if settings
+     * allow it), then the frame index in top-left corner
      */
     void updateScene();
 
+    /**
+     * Displays current scene in the window as seen by another camera, e.g. a CameraView. The main camera is
+     * active again afterwards.
+     * @param camera camera to render with
+     * @see updateScene()
+     */
+    void updateScene(ICameraSceneNode* camera);
+
+    /**
+     * Displays current scene in the window only if the bodies, the camera or the overlay changed since
+     * the last time it was displayed
+     * @return true if the scene was drawn, false if the window was already up to date
+     * @see updateScene()
+     */
+    bool redraw();
+
+    /**
+     * Same as redraw(), but an image of the frame cache is displayed instead of drawing the scene when the
+     * frame and the camera pose were already displayed, and drawn images are added to the cache. Reading
+     * the images back costs more than it saves while playing, so it is only meant for scrubbing.
+     * @return true if the window was updated, false if it was already up to date
+     * @see FrameCache
+     */
+    bool redrawCached();
+
+    /**
+     * Forgets the images of the frame cache, for instance when the trajectories change
+     */
+    void clearFrameCache();
+
+    /**
+     * Tells whether the window shows an outdated scene
+     * @return true if a body, the camera or the overlay changed since the last display
+     */
+    bool isDirty() const;
+
+    /**
+     * Marks the bodies of the scene as changed, so that the next redraw() displays them again
+     */
+    void invalidateScene();
+
     /**
      * Returns Irrlicht device
      * @return device
@@ -80,6 +142,12 @@ public:
      */
     IVideoDriver* getDriver() const;
 
+    /**
+     * Returns main camera, whose pose is the one displayed in the window
+     * @return camera
+     */
+    ICameraSceneNode* getCamera() const;
+
     /**
      * Creates a screenshot of the window and returns it
      * @return pointer to Irrlicht image
@@ -87,6 +155,13 @@ public:
      */
     IImage* createScreenshot() const;
 
+    /**
+     * Reads the current window content and converts it to I420 into the given converter
+     * @param converter converter whose frame size is the window size
+     * @see createScreenshot()
+     */
+    void captureFrame(YuvConverter& converter);
+
     /**
      * Takes a screenshot and saves it in screenshot folder
      * @param systemTime system time when the user takes the screenshot
@@ -145,6 +220,13 @@ public:
      */
     virtual void setTime(int time) override;
 
+    /**
+     * Moves the camera between the poses of two frames, for slow motion. The frame count text shows the
+     * previous frame.
+     * @param time fractional frame index
+     */
+    void setInterpolatedTime(double time);
+
     /**
      * Returns camera settings
      * @return camera settings
@@ -152,6 +234,12 @@ public:
      */
     const CameraSettings& getSettings() const;
 
+    /**
+     * Makes the camera follow a keyframed path instead of its per-frame trajectory
+     * @param path keyframed path, or nullptr to follow the per-frame trajectory again
+     */
+    void setPath(std::unique_ptr<CameraPath> path);
+
     /**
      * Sets whether camera trajectory file must be followed. If so, setTime() will move the camera according
      * to trajectory file. If not, setTime() won't move the camera.
@@ -172,12 +260,30 @@ private:
      */
     void setVirtualPosition(const vector3df& virtualPosition);
 
+    /**
+     * Loads the GUI and jersey fonts given in the settings
+     */
+    void loadFonts();
+
     /**
      * Updates the frame count text drawn on top-left corner of the window
      * @param frameCountNew new frame count
      */
     void setFrameCount(int frameCountNew);
 
+    /**
+     * Displays an image of the frame cache in the window
+     * @param image image of the window
+     * @return true if the image was displayed, false if the texture showing it could not be created
+     */
+    bool displayCachedImage(IImage* image);
+
+    /**
+     * Updates the durations of the frame stages drawn below the frame count
+     * @see FrameProfiler
+     */
+    void updateProfileText();
+
     CameraSettings mSettings;
 
     // Irrlicht scene and video components
@@ -193,7 +299,26 @@ private:
     IGUIFont* mGuiFont;
     stringw mFrameText;
     IGUIStaticText* mFrameCount;
+    IGUIStaticText* mProfileText;
     IGUIFont* mJerseyFont;
+    int mDisplayedFrame;
+
+    // Parts of the window changed since the last display of the main camera
+    bool mIsSceneDirty;
+    bool mIsCameraDirty;
+    bool mIsOverlayDirty;
+
+    // Keyframed trajectory, replacing the per-frame one if set
+    std::unique_ptr<CameraPath> mPath;
+
+    // Images already displayed, and texture showing them again
+    std::unique_ptr<FrameCache> mFrameCache;
+    ITexture* mCacheTexture;
+    // Bodies and camera are between two frames, so that the scene does not match the displayed frame
+    bool mIsBetweenFrames;
+
+    // Pixels of screenshots which are not in A8R8G8B8 format, converted before going to YuvConverter
+    std::vector<u8> mCaptureBuffer;
 
 };
 
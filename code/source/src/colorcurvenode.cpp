@@ -25,37 +25,128 @@ using namespace irr::core;
 using namespace irr::scene;
 using namespace irr::video;
 
-ColorCurveNode::ColorCurveNode(const SColor& trajColor, ISceneNode* parent, ISceneManager* mgr, s32 id)
+ColorCurveNode::ColorCurveNode(const SColor& trajColor, bool isFading, unsigned int capacity,
+                               ISceneNode* parent, ISceneManager* mgr, s32 id)
     : ISceneNode(parent, mgr, id)
 {
     // Set curve color
     mColor = trajColor;
+    mIsFading = isFading;
+
+    // Whole storage is allocated once, with the indices of the longest strip
+    mCapacity = max_(1u, capacity);
+    mFirst = 0;
+    mCount = 0;
+    mVertices.resize(2 * mCapacity);
+    mIndices.resize(mCapacity);
+    for(unsigned int i = 0; i < mCapacity; ++i) {
+        mIndices[i] = i;
+    }
+    for(auto& vertex : mVertices) {
+        vertex.Color = mColor;
+    }
+    mIsFadingOutdated = false;
 
     mMaterial.Wireframe = false;
     mMaterial.Lighting = false;
-    // Disable automatic culling to avoid calculating the bounding box
-    setAutomaticCulling(EAC_OFF);
+    // Fading is done with the alpha of the vertices, which makes the node transparent
+    mMaterial.MaterialType = mIsFading ? EMT_TRANSPARENT_VERTEX_ALPHA : EMT_SOLID;
+
+    // Points are in absolute coordinates, so the box of the curve is tested against the view frustum
+    mBox.reset(0, 0, 0);
+    mIsBoxOutdated = false;
+    setAutomaticCulling(EAC_FRUSTUM_BOX);
+}
+
+void ColorCurveNode::clear()
+{
+    mFirst = 0;
+    mCount = 0;
+    mBox.reset(0, 0, 0);
+    mIsBoxOutdated = false;
+}
+
+void ColorCurveNode::pushPoint(const vector3df& point)
+{
+    // Slot of the new point in the ring, replacing the oldest point if the ring is full
+    unsigned int slot;
+    if(mCount < mCapacity) {
+        slot = (mFirst + mCount) % mCapacity;
+        ++mCount;
+    } else {
+        slot = mFirst;
+        mFirst = (mFirst + 1) % mCapacity;
+        // Removed point may have been the only one on a side of the box
+        if(isOnBoxBorder(mVertices[slot].Pos))
+            mIsBoxOutdated = true;
+    }
+
+    if(mCount == 1)
+        mBox.reset(point);
+    else
+        mBox.addInternalPoint(point);
+
+    // Both copies are written, so that any window of the ring is contiguous in the second half
+    mVertices[slot].Pos = point;
+    mVertices[slot + mCapacity].Pos = point;
+
+    mIsFadingOutdated = mIsFading;
 }
 
 void ColorCurveNode::OnRegisterSceneNode()
 {
-    SceneManager->registerNodeForRendering(this);
+    // Box must be right before the scene manager culls the node, and a strip needs at least one line
+    if(IsVisible && mCount >= 2) {
+        if(mIsBoxOutdated)
+            updateBoundingBox();
+        SceneManager->registerNodeForRendering(this);
+    }
     ISceneNode::OnRegisterSceneNode();
 }
 
 void ColorCurveNode::render()
 {
+    // A strip needs at least one line
+    if(mCount < 2)
+        return;
+
+    if(mIsFadingOutdated)
+        updateFading();
+
     auto driver = SceneManager->getVideoDriver();
 
     driver->setMaterial(mMaterial);
     driver->setTransform(ETS_WORLD, AbsoluteTransformation);
 
-    // Draw each line composing the curve
-    for(unsigned int l = 0; l < mLines.size(); ++l) {
-        const std::pair<vector3df, vector3df >& singleLine = mLines[l];
-        driver->setMaterial(mMaterial);
-        driver->draw3DLine(singleLine.first, singleLine.second, mColor);
+    // Draw all the lines composing the curve in a single call, from the oldest point to the newest
+    driver->drawVertexPrimitiveList(&mVertices[mFirst], mCount,
+                                    mIndices.data(), mCount - 1,
+                                    EVT_STANDARD, EPT_LINE_STRIP, EIT_32BIT);
+}
+
+void ColorCurveNode::updateFading()
+{
+    // Oldest point is transparent, newest point keeps the alpha of the curve color
+    for(unsigned int rank = 0; rank < mCount; ++rank) {
+        mVertices[mFirst + rank].Color.setAlpha(mColor.getAlpha() * rank / max_(1u, mCount - 1));
     }
+    mIsFadingOutdated = false;
+}
+
+void ColorCurveNode::updateBoundingBox()
+{
+    mBox.reset(mVertices[mFirst].Pos);
+    for(unsigned int rank = 1; rank < mCount; ++rank) {
+        mBox.addInternalPoint(mVertices[mFirst + rank].Pos);
+    }
+    mIsBoxOutdated = false;
+}
+
+bool ColorCurveNode::isOnBoxBorder(const vector3df& point) const
+{
+    return point.X <= mBox.MinEdge.X || point.X >= mBox.MaxEdge.X
+            || point.Y <= mBox.MinEdge.Y || point.Y >= mBox.MaxEdge.Y
+            || point.Z <= mBox.MinEdge.Z || point.Z >= mBox.MaxEdge.Z;
 }
 
 const aabbox3d<f32>& ColorCurveNode::getBoundingBox() const
@@ -72,8 +163,3 @@ SMaterial& ColorCurveNode::getMaterial(u32 i)
 {
     return mMaterial;
 }
-
-void ColorCurveNode::setLines(const std::vector< std::pair<vector3df, vector3df > >& linePairs)
-{
-    mLines = linePairs;
-}
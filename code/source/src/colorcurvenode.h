@@ -30,27 +30,41 @@ using namespace irr::video;
 /**
  * @brief Node representing 3D color curves
  *
- * Displays 3D color curves by drawing a fixed number of points on the wanted positions.
+ * Displays 3D color curves as a single line strip. The points are kept in a ring buffer of fixed capacity:
+ * adding a point overwrites the oldest one, so that a curve following a body costs constant time and no
+ * allocation per frame. The ring is stored twice in a row in the vertex array, which makes the points from
+ * the oldest to the newest contiguous, and the whole curve is drawn with one draw call. The curve can fade
+ * out, from the color of the newest point to transparent at the oldest one.
+ *
+ * The bounding box grows with each new point, so that curves out of the view are culled. It is only
+ * computed again from all the points when a removed point was on its border.
  */
 class ColorCurveNode : public ISceneNode
 {
 public:
 
-    /**
-     * Sets the lines composing the curve
-     * @param linePairs vector containing lines, which are actually 3D-point pairs
-     */
-    void setLines(const std::vector< std::pair<vector3df, vector3df > > & linePairs);
-
     /**
      * Creates color curve with the wanted color
      * @param trajColor color of the curve
+     * @param isFading true if the curve fades out towards its oldest point
+     * @param capacity maximum number of points of the curve
      * @param parent parent node
      * @param mgr scene manager
      * @param id node ID
      */
-    ColorCurveNode(const SColor& trajColor, ISceneNode* parent, ISceneManager* mgr, s32 id = 0);
+    ColorCurveNode(const SColor& trajColor, bool isFading, unsigned int capacity,
+                   ISceneNode* parent, ISceneManager* mgr, s32 id = 0);
+
+    /**
+     * Removes all the points of the curve
+     */
+    void clear();
 
+    /**
+     * Adds a newest point to the curve. If the curve is full, its oldest point is removed.
+     * @param point position of the new point
+     */
+    void pushPoint(const vector3df& point);
 
     /**
      * Mandatory method for custom scene node
@@ -79,11 +93,37 @@ public:
 
 private:
 
-    std::vector< std::pair<vector3df, vector3df > > mLines;
+    /**
+     * Gives each point of a fading curve its alpha according to its rank, since ranks change with every new point
+     */
+    void updateFading();
+
+    /**
+     * Computes the bounding box from all the points of the curve
+     */
+    void updateBoundingBox();
+
+    /**
+     * Tells whether a point is on the border of the bounding box, so that removing it may shrink the box
+     * @param point position of the point
+     * @return true if the point is on the border
+     */
+    bool isOnBoxBorder(const vector3df& point) const;
+
     SColor mColor;
+    bool mIsFading;
+
+    // Ring buffer stored twice, with the oldest point at mFirst and the others following it
+    unsigned int mCapacity;
+    unsigned int mFirst;
+    unsigned int mCount;
+    std::vector<S3DVertex> mVertices;
+    std::vector<u32> mIndices;
+    bool mIsFadingOutdated;
 
     // Mandatory members for custom scene node
     aabbox3d<f32> mBox;
+    bool mIsBoxOutdated;
     SMaterial mMaterial;
 
 };
@@ -29,7 +29,8 @@ using namespace irr::scene;
 using namespace irr::core;
 using namespace irr::video;
 
-Court::Court(const CourtSettings& courtSettings,
+Court::Court(Engine& engine,
+             const CourtSettings& courtSettings,
              std::unique_ptr< PlayerMap > playerMap,
              std::unique_ptr<MovingBody> ball)
 {
@@ -37,18 +38,17 @@ Court::Court(const CourtSettings& courtSettings,
     //mPlayers = playerMap;
     mBall = std::move(ball);
 
-    CameraWindow& cam = Engine::getInstance().getCameraWindow();
+    CameraWindow& cam = engine.getCameraWindow();
     auto sceneManager = cam.getSceneManager();
 
-    Engine& engine = Engine::getInstance();
-
-    if(sceneManager->loadScene(courtSettings.mScenePath) == false) {
-        engine.throwError(L"Scene file could not be loaded");
+    mSceneRoot = sceneManager->addEmptySceneNode();
+    if(sceneManager->loadScene(courtSettings.mScenePath, nullptr, mSceneRoot) == false) {
+        Engine::throwError(L"Scene file could not be loaded");
     }
 
     mNode = sceneManager->getSceneNodeFromName("court");
     if(mNode == nullptr) {
-        engine.throwError(L"Scene file does not contain court node");
+        Engine::throwError(L"Scene file does not contain court node");
     }
 
     mNode->setVisible(true);
@@ -63,6 +63,10 @@ Court::Court(const CourtSettings& courtSettings,
 
 Court::~Court()
 {
+    // Bodies are removed first, then the background scene
+    mPlayers.reset();
+    mBall.reset();
+    mSceneRoot->remove();
 }
 
 void Court::updateTrajectories(const std::map<int, VectorSequence>& playerChunk,
@@ -77,12 +81,24 @@ void Court::updateTrajectories(const std::map<int, VectorSequence>& playerChunk,
 }
 
 void Court::setTime(int time)
+{
+    // Bodies already showing this time keep their nodes untouched
+    for(auto i = mPlayers->cbegin(); i != mPlayers->cend(); ++i) {
+        if(!i->second->isUpToDate(time))
+            i->second->setTime(time);
+    }
+
+    if(!mBall->isUpToDate(time))
+        mBall->setTime(time);
+}
+
+void Court::setInterpolatedTime(double time)
 {
     for(auto i = mPlayers->cbegin(); i != mPlayers->cend(); ++i) {
-        i->second->setTime(time);
+        i->second->setInterpolatedTime(time);
     }
 
-    mBall->setTime(time);
+    mBall->setInterpolatedTime(time);
 }
 
 const std::map<int, std::unique_ptr<Player> > & Court::getPlayers() const
@@ -30,6 +30,8 @@ using namespace irr::core;
 
 typedef std::map<int, std::unique_ptr<Player> > PlayerMap;
 
+class Engine;
+
 /**
  * @brief Court containing players and ball
  *
@@ -43,14 +45,16 @@ public:
 
     /**
      * Constructs the court using the given settings
+     * @param engine engine whose window displays the court
      * @param courtSettings court settings used to construct
      * @param playerMap players to use
      * @param ball ball to use
      */
-    Court(const CourtSettings& courtSettings, std::unique_ptr<PlayerMap> playerMap, std::unique_ptr<MovingBody> ball);
+    Court(Engine& engine, const CourtSettings& courtSettings,
+          std::unique_ptr<PlayerMap> playerMap, std::unique_ptr<MovingBody> ball);
 
     /**
-     * Releases memory for all the players and the ball
+     * Releases memory for all the players and the ball, and removes the scene from the window
      */
     virtual ~Court();
 
@@ -64,11 +68,18 @@ public:
 
     /**
      * Moves the players and the ball to the position (and orientation if player) according to their
-     * trajectory data.
+     * trajectory data. Bodies which already show this time are skipped.
      * @param time time index
      */
     virtual void setTime(int time) override;
 
+    /**
+     * Moves the players and the ball between two frames, for slow motion
+     * @param time fractional frame index
+     * @see MovingBody::setInterpolatedTime()
+     */
+    void setInterpolatedTime(double time);
+
     /**
      * Returns the players
      * @return player map
@@ -76,6 +87,8 @@ public:
     const std::map<int, std::unique_ptr<Player> >& getPlayers() const;
 
 private:
+    // Parent of the nodes loaded from the scene file, to remove them with the court
+    ISceneNode* mSceneRoot;
     ISceneNode* mNode;
     std::unique_ptr<PlayerMap> mPlayers;
     std::unique_ptr<MovingBody> mBall;
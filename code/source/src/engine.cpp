@@ -21,9 +21,15 @@
 #include <iomanip>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <functional>
+#include <cmath>
 #include <irrlicht.h>
-#include <revel.h>
-#include <QTime>
+#include <QDir>
+#include <QFileInfo>
+#include <stdexcept>
 #include <locale.h>
 
 #include "mainwindow.h"
@@ -32,6 +38,14 @@
 #include "camerawindow.h"
 #include "affinetransformation.h"
 #include "court.h"
+#include "yuvconverter.h"
+#include "frameprofiler.h"
+#include "tracerecorder.h"
+#include "nullvideosink.h"
+#include "recordingmanifest.h"
+#include "videojoiner.h"
+#include "renderdaemon.h"
+#include "renderclient.h"
 #include "engine.h"
 
 using namespace tinyxml2;
@@ -40,10 +54,13 @@ using namespace irr;
 using namespace irr::core;
 using namespace irr::video;
 
-Engine& Engine::getInstance()
+namespace
 {
-    static Engine instance;
-    return instance;
+    // In daemon mode, errors only make the current job fail
+    bool areErrorsThrown = false;
+
+    // Worker threads always throw, their errors being reported by the thread waiting for them
+    thread_local bool areThreadErrorsThrown = false;
 }
 
 Engine::Engine()
@@ -51,13 +68,23 @@ Engine::Engine()
     // Set standard locale to avoid XML float parsing problems
     setlocale(LC_NUMERIC, "C");
     mIsRecording = false;
+    mRecordedImages = 0;
     mIsPlaying = false;
     mIsLivePlaying = false;
+    mPlaybackRate = 1;
     mCurrentFrame = 0;
+    mPlayedFrames = 0;
+    mLateFrames = 0;
+    mDroppedFrames = 0;
 }
 
 Engine::~Engine()
 {
+    // Bodies and cameras must leave the scene before the window is destroyed
+    mViews.clear();
+    mCourt.reset();
+    mJerseyAtlas.reset();
+    mPoseCache.reset();
 
 //    mBallStream->close();
 //    mPlayerStream->close();
@@ -66,12 +93,29 @@ Engine::~Engine()
 
 int Engine::start(const QApplication& app, const std::vector<std::string>& args)
 {
+    // Daemon and client of the daemon are chosen by the first argument
+    if(args.size() >= 2 && args.at(1) == "--daemon") {
+        RenderDaemon daemon(*this, args.size() >= 3 ? args.at(2) : RenderDaemon::DEFAULT_SERVER_NAME);
+        // Errors of a job must not stop the daemon
+        areErrorsThrown = true;
+        return app.exec();
+    }
+    if(args.size() >= 2 && args.at(1) == "--submit") {
+        return RenderClient::submit(std::vector<std::string>(args.begin() + 2, args.end()));
+    }
+
     if(args.size() != 2) {
         throwError(L"bad arguments, only a unique XML file is accepted as argument");
     }
 
     loadSettings(args.at(1));
 
+    // Timeline covers loading of the trajectories and the whole run
+    if(!mSequenceSettings.mTracePath.empty()) {
+        TraceRecorder::setThreadName("main");
+        TraceRecorder::start(mSequenceSettings.mTracePath);
+    }
+
     if(mSequenceSettings.mMode == MODE_GUI || mSequenceSettings.mMode == MODE_CONSOLE) {
         updateTrajectories(mSequenceSettings.mFrameNumber);
         setTime(mSequenceSettings.mInitialTime);
@@ -79,9 +123,11 @@ int Engine::start(const QApplication& app, const std::vector<std::string>& args)
 
     switch(mSequenceSettings.mMode) {
         case MODE_GUI: {
-            MainWindow mainWindow;
+            MainWindow mainWindow(*this);
             mainWindow.show();
-            return app.exec();
+            int status = app.exec();
+            TraceRecorder::stop();
+            return status;
         }
         case MODE_CONSOLE: {
             saveVideo(mSequenceSettings.mStartTime, mSequenceSettings.mEndTime);
@@ -89,15 +135,21 @@ int Engine::start(const QApplication& app, const std::vector<std::string>& args)
         break;
 
         case MODE_LIVE: {
-            MainWindow mw;
+            MainWindow mw(*this);
             mw.show();
             mw.setFollowTrajectory(false);
             mw.blockAnimationTab();
             livePlay();
         }
         break;
+
+        case MODE_BENCHMARK: {
+            runBenchmark(mSequenceSettings.mStartTime, mSequenceSettings.mEndTime);
+        }
+        break;
     }
 
+    TraceRecorder::stop();
     return 0;
 }
 
@@ -105,7 +157,13 @@ void Engine::loadSettings(const std::string& cfgPath)
 {
     setlocale(LC_NUMERIC, "C");
 
-    mFactory = std::unique_ptr<AvatarsFactory>(new AvatarsFactory(cfgPath));
+    // Bodies and cameras of a previous configuration are attached to the current window
+    mViews.clear();
+    mViewStreams.clear();
+    mCourt.reset();
+    mJerseyAtlas.reset();
+
+    mFactory = std::unique_ptr<AvatarsFactory>(new AvatarsFactory(*this, cfgPath));
 
     mCameraStream = mFactory->createCameraStream();
     mPlayerStream = mFactory->createPlayerStream();
@@ -114,39 +172,118 @@ void Engine::loadSettings(const std::string& cfgPath)
     // Initialize all the components of the program
     mSequenceSettings = mFactory->retrieveSequenceSettings();
     mTransformation = mFactory->createTransformation();
-    mCameraWindow = mFactory->createCamera();
+
+    // A resident window is reused when possible, which keeps the device with its mesh, texture and font caches
+    auto cameraSettings = mFactory->retrieveCameraSettings();
+    if(mCameraWindow != nullptr && mCameraWindow->isCompatible(cameraSettings)) {
+        mCameraWindow->resetSettings(cameraSettings);
+    } else {
+        mPoseCache.reset();
+        mCameraWindow.reset();
+        mCameraWindow = mFactory->createCamera();
+        // Poses belong to the meshes of the scene manager of the window
+        mPoseCache = std::unique_ptr<PoseCache>(
+                    new PoseCache(mCameraWindow->getSceneManager()));
+    }
     mCourt = mFactory->createCourt();
+
+    // Jerseys are drawn before the first frame, or loaded from a previous run
+    mJerseyAtlas = mFactory->createJerseyAtlas();
+    mJerseyAtlas->bake(mCourt->getPlayers());
+
+    // Keyframed camera paths are read at once and evaluated on demand, instead of being read by chunks
+    if(mCameraWindow->getSettings().mKeyframes) {
+        mCameraWindow->setPath(mFactory->createCameraPath(*mCameraStream));
+        mCameraStream.reset();
+    }
+
+    mViews = mFactory->createViews();
+    for(auto& view : mViews) {
+        auto viewStream = mFactory->createViewStream(*view);
+        if(view->getSettings().mKeyframes) {
+            view->setPath(mFactory->createCameraPath(*viewStream));
+            viewStream.reset();
+        }
+        mViewStreams.push_back(std::move(viewStream));
+    }
 }
 
 void Engine::updateTrajectories(int nbFramesToCatch)
 {
-    // Catch new chunks from streams
-    auto& cameraChunk = mFactory->createCameraChunk(*mCameraStream, nbFramesToCatch);
-    auto& playerChunk = mFactory->createPlayerChunkMap(*mPlayerStream, mCourt->getPlayers(), nbFramesToCatch);
-    auto& ballChunk = mFactory->createBallChunk(*mBallStream, nbFramesToCatch);
+    TraceRecorder::Span span("ingestion");
+
+    std::map<int, VectorSequence> playerChunk;
+    VectorSequence ballChunk;
+    {
+        FrameProfiler::ScopedTimer timer(FrameProfiler::STAGE_INGESTION);
+
+        // Catch new chunks from streams
+        playerChunk = mFactory->createPlayerChunkMap(*mPlayerStream, mCourt->getPlayers(), nbFramesToCatch);
+        ballChunk = mFactory->createBallChunk(*mBallStream, nbFramesToCatch);
 
-    // Update camera trajectory
-    mCameraWindow->updatePositions(cameraChunk.first);
-    mCameraWindow->updateRotations(cameraChunk.second);
+        // Update camera trajectory, unless it is keyframed
+        if(mCameraStream != nullptr) {
+            auto& cameraChunk = mFactory->createCameraChunk(*mCameraStream, nbFramesToCatch);
+            mCameraWindow->updatePositions(cameraChunk.first);
+            mCameraWindow->updateRotations(cameraChunk.second);
+        }
+
+        // Update trajectories of additional cameras
+        for(unsigned int i = 0; i < mViews.size(); ++i) {
+            if(mViewStreams[i] == nullptr)
+                continue;
+            auto& viewChunk = mFactory->createCameraChunk(*mViewStreams[i], nbFramesToCatch);
+            mViews[i]->updatePositions(viewChunk.first);
+            mViews[i]->updateRotations(viewChunk.second);
+        }
+    }
 
     // Update player and ball trajectories
+    FrameProfiler::ScopedTimer kinematicsTimer(FrameProfiler::STAGE_KINEMATICS);
+    TraceRecorder::Span kinematicsSpan("kinematics");
     mCourt->updateTrajectories(playerChunk, ballChunk);
+
+    // New positions change the speeds and animations around the end of the previous chunk
+    mCameraWindow->clearFrameCache();
 }
 
 void Engine::throwError(const stringw& errorMessage)
 {
+    if(areErrorsThrown || areThreadErrorsThrown) {
+        throw std::runtime_error(QString::fromWCharArray(errorMessage.c_str()).toStdString());
+    }
+
     std::wcerr << "Error: " << errorMessage.c_str() << std::endl;
     exit(1);
 }
 
+void Engine::throwErrorsOnThisThread()
+{
+    areThreadErrorsThrown = true;
+}
+
 void Engine::setTime(int time)
+{
+    applyTime(time);
+    redraw();
+}
+
+void Engine::applyTime(int time)
 {
     mCurrentFrame = time;
+    TraceRecorder::setFrame(time);
 
-    mCourt->setTime(time);
+    {
+        FrameProfiler::ScopedTimer timer(FrameProfiler::STAGE_COURT);
+        mCourt->setTime(time);
+    }
 
     mCameraWindow->setTime(time);
-    mCameraWindow->updateScene();
+}
+
+bool Engine::redraw()
+{
+    return mCameraWindow->redraw();
 }
 
 const SequenceSettings &Engine::getSequenceSettings() const
@@ -176,27 +313,141 @@ int Engine::getCurrentFrame() const
 
 void Engine::play(int from, int to)
 {
-    // Calculate frametime in milliseconds from framerate
-    int frametime = (1.0 / (mSequenceSettings.mFramerate)) * 1000;
+    typedef std::chrono::steady_clock Clock;
+
+    // Live playing reports once for all its chunks. Its mode is kept until the end of the chunk, even if
+    // live playing is stopped meanwhile.
+    bool isLive = mIsLivePlaying;
+    if(!isLive)
+        resetPlaybackStatistics();
+
+    // Image n is displayed during [start + n * image time, start + (n + 1) * image time) and shows the time
+    // startTime + n * step, images being at the output frame rate. Both are computed from the start so that
+    // errors do not accumulate over a match, and the start is moved to the current image when the rate changes.
+    std::chrono::duration<double> imageTime(1.0 / mSequenceSettings.mOutputFramerate);
+    auto getStep = [&]() {
+        double rate = isLive ? 1 : mPlaybackRate;
+        return rate * mSequenceSettings.mFramerate / mSequenceSettings.mOutputFramerate;
+    };
+    auto start = Clock::now();
+    double step = getStep();
+    double startTime = from;
+    double time = from;
+    int nbImages = 0;
+    int appliedFrame = from - 1;
+
+    // Live chunks follow each other on the timeline begun by livePlay(). Image k shows the time
+    // k * input rate / output rate, as in recordRange(), and the images from the end of a chunk on are left to
+    // the next one, so that no image is shown twice or skipped between chunks.
+    long long inputRate = mSequenceSettings.mFramerate;
+    long long outputRate = mSequenceSettings.mOutputFramerate;
+    long long endImage = 0;
+    if(isLive) {
+        start = mLiveStart;
+        nbImages = (int) ((from * outputRate + inputRate - 1) / inputRate);
+        endImage = ((to + 1) * outputRate + inputRate - 1) / inputRate;
+        time = (double) (nbImages * inputRate) / outputRate;
+    }
 
-    QTime timer;
     mIsPlaying = true;
-    for(int i = from; i <= to; ++i) {
-        timer.restart();
-        setTime(i);
-
-        // Wait frame time
-        int remaining = frametime - timer.elapsed();
-        if(remaining > 0)
-            mCameraWindow->getDevice()->sleep(remaining);
+    while(isLive ? nbImages < endImage : time <= to) {
+        auto deadline = start + std::chrono::duration_cast<Clock::duration>(imageTime * (nbImages + 1));
+
+        // Frames skipped by fast-forward or by a dropped image are still applied
+        advanceTo(time, appliedFrame);
+
+        // An image whose time is over is not drawn, which lets playback catch up
+        if(Clock::now() < deadline) {
+            redraw();
+            if(Clock::now() > deadline) {
+                ++mLateFrames;
+                TraceRecorder::addCounter("late frames", mLateFrames);
+            }
+        } else {
+            ++mDroppedFrames;
+            TraceRecorder::addCounter("dropped frames", mDroppedFrames);
+        }
+        ++mPlayedFrames;
 
         // Stops to play to process events and check for interruption
-        QApplication::processEvents();
+        {
+            TraceRecorder::Span span("events");
+            QApplication::processEvents();
+        }
         if(!mIsPlaying) {
             break;
         }
+
+        // Remaining time of the image is spent waiting, also for the last one so that it is shown as long as
+        // the others
+        std::this_thread::sleep_until(deadline);
+        if(!isLive && time >= to) {
+            break;
+        }
+
+        // A new rate applies from the next image on
+        double newStep = getStep();
+        if(newStep != step) {
+            step = newStep;
+            startTime = time;
+            start = deadline - std::chrono::duration_cast<Clock::duration>(imageTime);
+            nbImages = 0;
+        }
+
+        ++nbImages;
+        if(isLive)
+            time = (double) (nbImages * inputRate) / outputRate;
+        else
+            time = std::min(startTime + nbImages * step, (double) to);
     }
     mIsPlaying = false;
+
+    if(!isLive)
+        printPlaybackStatistics("playback");
+}
+
+void Engine::advanceTo(double time, int& appliedFrame)
+{
+    // Bodies move through every frame, so that trails and animations stay continuous when frames are skipped
+    int frame = (int) std::floor(time);
+    for(int i = appliedFrame + 1; i <= frame; ++i) {
+        applyTime(i);
+    }
+    appliedFrame = std::max(appliedFrame, frame);
+
+    // Images between two frames show the bodies on their way to the next frame
+    if(time > frame)
+        applyInterpolatedTime(time);
+}
+
+void Engine::applyInterpolatedTime(double time)
+{
+    {
+        FrameProfiler::ScopedTimer timer(FrameProfiler::STAGE_COURT);
+        mCourt->setInterpolatedTime(time);
+    }
+
+    mCameraWindow->setInterpolatedTime(time);
+}
+
+void Engine::setPlaybackRate(double rate)
+{
+    mPlaybackRate = std::min(std::max(rate, 0.25), 16.0);
+}
+
+void Engine::resetPlaybackStatistics()
+{
+    mPlayedFrames = 0;
+    mLateFrames = 0;
+    mDroppedFrames = 0;
+    FrameProfiler::reset();
+}
+
+void Engine::printPlaybackStatistics(const std::string& title) const
+{
+    std::cout << "Played " << mPlayedFrames << " images: " << mLateFrames << " late, "
+              << mDroppedFrames << " dropped" << std::endl;
+    FrameProfiler::printReport(std::cout, title);
 }
 
 const AffineTransformation& Engine::getAffineTransformation() const
@@ -213,170 +464,222 @@ void Engine::saveVideo(int from, int to)
     // Define window size and frames to encode
     auto windowSize = mCameraWindow->getSettings().mWindowSize;
 
-    int width = windowSize.Width;
-    int height = windowSize.Height;
-    int encodingFrameNumber = to - from;
-
-    //------------------------------------------------------------------------------------------------------
-    // The following is a code snippet from Revel examples, with some modifications to interrupt recording
-    //------------------------------------------------------------------------------------------------------
-
-    // Make sure the API version of Revel we're compiling against matches the
-    // header files!  This is terribly important!
-    if (REVEL_API_VERSION != Revel_GetApiVersion()) {
-        printf("ERROR: Revel version mismatch!\n");
-        printf("Headers: version %06x, API version %d\n", REVEL_VERSION, REVEL_API_VERSION);
-        printf("Library: version %06x, API version %d\n", Revel_GetVersion(), Revel_GetApiVersion());
-        exit(1);
-    }
-
-    // Create an encoder
-    int encoderHandle;
-    Revel_Error revError = Revel_CreateEncoder(&encoderHandle);
-    if (revError != REVEL_ERR_NONE) {
-        printf("Revel Error while creating encoder: %d\n", revError);
-        exit(1);
-    }
-
-    // Set up the encoding parameters.  ALWAYS call Revel_InitializeParams()
-    // before filling in your application's parameters, to ensure that all
-    // fields especially ones that you may not know about) are initialized
-    // to safe values.
-    Revel_Params revParams;
-    Revel_InitializeParams(&revParams);
-    revParams.width = width;
-    revParams.height = height;
-    revParams.frameRate = mSequenceSettings.mFramerate;
-    revParams.quality = 1.0f;
-    revParams.codec = REVEL_CD_XVID;
-
-    revParams.hasAudio = false;
-    revParams.audioChannels = 2;
-    revParams.audioRate = 22050;
-    revParams.audioBits = 16;
-    revParams.audioSampleFormat = REVEL_ASF_PCM;
-
-    // Initialize encoding
-    revError = Revel_EncodeStart(encoderHandle,
-                                 mSequenceSettings.mVideoOutputName.c_str(),
-                                 &revParams);
-    if (revError != REVEL_ERR_NONE) {
-        printf("Revel Error while starting encoding: %d\n", revError);
-        exit(1);
-    }
+    // One output for the main camera, then one per additional camera
+    std::vector<std::string> outputNames;
+    outputNames.push_back(mSequenceSettings.mVideoOutputName);
+    for(auto& view : mViews)
+        outputNames.push_back(view->getSettings().mOutputName);
 
-    // Choose video settings
-    Revel_VideoFrame frame;
-    frame.width = width;
-    frame.height = height;
-    frame.bytesPerPixel = 4;
-    frame.pixelFormat = REVEL_PF_BGRA;
-    // Irrlicht U32 -> Revel BGRA, U32 ABGR -> Revel RGBA
-    frame.pixels = new int[width*height];
-    memset(frame.pixels, 0, width*height*4);
-    int* pixels = (int*) frame.pixels;
+    // Planes are allocated once and reused for every frame
+    YuvConverter converter(windowSize.Width, windowSize.Height);
 
     // Discard preceding events
     mCameraWindow->getDevice()->run();
     mIsRecording = true;
-    // Fill pixel array for each frame
-    for(int i = from; i <= to; ++i)
-    {
-        setTime(i);
-        IImage* image = mCameraWindow->createScreenshot();
-        int pixelCounter = 0;
-        for(unsigned int y = 0; y < frame.height; ++y) {
-            for(unsigned int x = 0; x < frame.width; ++x) {
-
-                pixels[pixelCounter] = image->getPixel(x,y).color;
-
-                // Change color format
-//                SColor pixel = image->getPixel(x, y);
-//                u8 blue = pixel.getBlue(),
-//                   green = pixel.getGreen(),
-//                   red = pixel.getRed(),
-//                   alpha = pixel.getAlpha();
-//                u32 color =
-//                        (alpha << 24)
-//                        | (blue << 16)
-//                        | (green << 8)
-//                        | red;
-//                pixels[pixelCounter] = color;
-                // Short version
-//                pixels[pixelCounter] =
-//                    (pixel.getAlpha() << 24)
-//                    | (pixel.getBlue() << 16)
-//                    | (pixel.getGreen() << 8)
-//                    | pixel.getRed();
-
-                ++pixelCounter;
+    FrameProfiler::reset();
+
+    int checkpointLength = mSequenceSettings.mVideoCheckpointLength;
+    if(checkpointLength == 0) {
+        recordRange(from, to, outputNames, converter);
+    } else {
+        // Segments of a previous run are reused only if it recorded the same video from the same inputs. The
+        // configuration, trajectory and jersey files are identified by a hash of their paths and modification
+        // times, since the description is a single line of the manifest.
+        std::string inputs = mFactory->describeInputs() + mJerseyAtlas->describe(mCourt->getPlayers());
+        std::ostringstream description;
+        description << from << " " << to << " " << checkpointLength << " "
+                    << windowSize.Width << " " << windowSize.Height << " "
+                    << mSequenceSettings.mFramerate << " " << mSequenceSettings.mOutputFramerate << " "
+                    << mSequenceSettings.mInterpolation << " " << mSequenceSettings.mVideoFormat << " "
+                    << std::hex << std::setw(16) << std::setfill('0') << std::hash<std::string>()(inputs);
+
+        // Outputs are checkpointed together, but a crash may happen between two manifest updates
+        std::vector<std::unique_ptr<RecordingManifest>> manifests;
+        int resumeFrame = to + 1;
+        for(auto& outputName : outputNames) {
+            manifests.push_back(std::unique_ptr<RecordingManifest>(
+                                    new RecordingManifest(outputName, description.str())));
+            manifests.back()->load();
+            resumeFrame = std::min(resumeFrame, manifests.back()->getResumeFrame(from));
+        }
+        for(auto& manifest : manifests)
+            manifest->truncate(resumeFrame);
+
+        if(resumeFrame > from)
+            std::cout << "Resuming recording from frame " << resumeFrame << std::endl;
+
+        bool isComplete = true;
+        for(int first = resumeFrame; first <= to; first += checkpointLength) {
+            int last = std::min(first + checkpointLength - 1, to);
+
+            std::vector<std::string> segmentNames;
+            for(auto& manifest : manifests)
+                segmentNames.push_back(manifest->getNextSegmentFileName());
+
+            if(!recordRange(first, last, segmentNames, converter)) {
+                isComplete = false;
+                break;
             }
+
+            for(unsigned int i = 0; i < manifests.size(); ++i)
+                manifests[i]->addSegment(first, last, segmentNames[i]);
         }
 
-        // Drop Irrlicht resource after its process
-        image->drop();
+        if(isComplete) {
+            for(unsigned int i = 0; i < manifests.size(); ++i) {
+                std::vector<std::string> segmentNames;
+                for(auto& segment : manifests[i]->getSegments())
+                    segmentNames.push_back(segment.mFileName);
+                VideoJoiner::join(segmentNames, outputNames[i], mSequenceSettings.mVideoFormat,
+                                  windowSize.Width, windowSize.Height, mSequenceSettings.mOutputFramerate);
+                manifests[i]->remove();
+            }
+        } else {
+            std::cout << "Recording interrupted, next run will resume from frame "
+                      << manifests.front()->getResumeFrame(from) << std::endl;
+        }
+    }
+    mIsRecording = false;
+    FrameProfiler::printReport(std::cout, "recording");
 
-        int frameSize;
-        revError = Revel_EncodeFrame(encoderHandle, &frame, &frameSize);
-        if (revError != REVEL_ERR_NONE) {
-            printf("Revel Error while writing frame: %d\n", revError);
-            exit(1);
+    // Restore current frame because video encoding changed it
+    setTime(beforeTime);
+}
+
+bool Engine::recordRange(int from, int to, const std::vector<std::string>& fileNames, YuvConverter& converter)
+{
+    dimension2d<u32> frameSize(converter.getWidth(), converter.getHeight());
+    std::vector<std::unique_ptr<VideoSink>> sinks;
+    for(auto& fileName : fileNames)
+        sinks.push_back(mFactory->createVideoSink(mSequenceSettings, fileName, frameSize));
+
+    // Frame i lasts from time i to time i + 1. Image k of the output is at time k * input rate / output rate,
+    // so that the images of consecutive ranges follow each other at the output frame rate.
+    long long inputRate = mSequenceSettings.mFramerate;
+    long long outputRate = mSequenceSettings.mOutputFramerate;
+    long long firstImage = (from * outputRate + inputRate - 1) / inputRate;
+    long long endImage = ((to + 1) * outputRate + inputRate - 1) / inputRate;
+
+    // Convert and write each image
+    mRecordedImages = 0;
+    bool isComplete = true;
+    int appliedFrame = from - 1;
+    for(long long k = firstImage; k < endImage; ++k)
+    {
+        // Court and main camera are updated once, and the scene is drawn with the main camera. Drawing is
+        // forced because the window content is captured, even if the frame did not change.
+        double time = (double) (k * inputRate) / outputRate;
+        bool isBetweenFrames = (k * inputRate) % outputRate != 0;
+        int frame = (int) ((k * inputRate) / outputRate);
+        advanceTo(time, appliedFrame);
+        mCameraWindow->updateScene();
+        mCameraWindow->captureFrame(converter);
+        sinks[0]->writeFrame(converter);
+
+        // The same scene is drawn again with each additional camera
+        for(unsigned int v = 0; v < mViews.size(); ++v) {
+            if(isBetweenFrames)
+                mViews[v]->setInterpolatedTime(time);
+            else
+                mViews[v]->setTime(frame);
+            mCameraWindow->updateScene(mViews[v]->getCamera());
+            mCameraWindow->captureFrame(converter);
+            sinks[v + 1]->writeFrame(converter);
         }
-        // printf("Frame %d of %d: %d bytes\n", i+1, encodingFrameNumbers,
-        // frameSize);
+        ++mRecordedImages;
+
+        if(mRecordingProgress)
+            mRecordingProgress(frame);
 
         // Process Irrlicht events and check for interruption
-        mCameraWindow->getDevice()->run();
+        {
+            TraceRecorder::Span span("events");
+            mCameraWindow->getDevice()->run();
+        }
         if(!mIsRecording) {
+            isComplete = k == endImage - 1;
             break;
         }
     }
-    mIsRecording = false;
 
-    // Choose audio settings
-    int totalAudioBytes = 0;
-    int audioBufferSize = encodingFrameNumber;
-    char* audioBuffer = new char[encodingFrameNumber];
-    for(int i = 0; i < encodingFrameNumber; ++i)
-        audioBuffer[i] = 0;
-    revError = Revel_EncodeAudio(
-                            encoderHandle,
-                            audioBuffer,
-                            audioBufferSize,
-                            &totalAudioBytes);
-    if (revError != REVEL_ERR_NONE) {
-        printf("Revel Error while writing audio: %d\n", revError);
-        exit(1);
-    }
-    // printf("Encoded %d bytes of audio\n", totalAudioBytes);
-
-    // Finalize encoding. If this step is skipped, the output movie will
-    // be unviewable!
-    int totalSize;
-    revError = Revel_EncodeEnd(encoderHandle, &totalSize);
-    if (revError != REVEL_ERR_NONE){
-        printf("Revel Error while ending encoding: %d\n", revError);
-        exit(1);
-    }
+    // Interrupted recordings are still finalized so that they can be viewed
+    for(auto& sink : sinks)
+        sink->finish();
 
-    // printf("%s written: %dx%d, %d frames, %d bytes\n", videoName.c_str(),
-    // width, height, encodingFrameNumber, totalSize);
-    // Final cleanup
-    Revel_DestroyEncoder(encoderHandle);
-    if (audioBuffer != NULL)
-        delete [] audioBuffer;
-    delete [] (int*)frame.pixels;
+    return isComplete;
+}
 
-    //    const float MBSize = 1048576.0;
-    //    float size = totalSize / MBSize;
-    //    std::cout.setf(std::ios::fixed);
-    //    std::cout << videoName << " (" << std::setprecision(2) << size <<
-    //    " MB) saved in " << width << "*" << height << " with " <<
-    //    encodingFrameNumber << " frames" << std::endl;
+void Engine::runBenchmark(int from, int to)
+{
+    auto windowSize = mCameraWindow->getSettings().mWindowSize;
+    FrameProfiler::reset();
 
+    // Trajectories are loaded and their kinematics computed as in the other modes, but measured
+    auto loadBegin = std::chrono::steady_clock::now();
+    updateTrajectories(mSequenceSettings.mFrameNumber);
+    std::chrono::duration<double> loadTime = std::chrono::steady_clock::now() - loadBegin;
 
-    // Restore current frame because video encoding changed it
-    setTime(beforeTime);
+    // Every camera is rendered, read back and converted, then the frames go to null sinks
+    std::vector<std::string> outputNames(1 + mViews.size());
+    YuvConverter converter(windowSize.Width, windowSize.Height);
+    mCameraWindow->getDevice()->run();
+    mIsRecording = true;
+
+    auto renderBegin = std::chrono::steady_clock::now();
+    recordRange(from, to, outputNames, converter);
+    std::chrono::duration<double> renderTime = std::chrono::steady_clock::now() - renderBegin;
+    mIsRecording = false;
+
+    // Images are at the output frame rate, which can differ from the one of the trajectories
+    std::cout << "Benchmark: " << mCourt->getPlayers().size() << " players, "
+              << mSequenceSettings.mFrameNumber << " frames loaded, "
+              << mRecordedImages << " images at " << mSequenceSettings.mOutputFramerate << " fps rendered with "
+              << outputNames.size() << " camera(s) at "
+              << windowSize.Width << "x" << windowSize.Height << std::endl;
+    std::cout << "Loading and kinematics: " << loadTime.count() << " s" << std::endl;
+    std::cout << "Rendering: " << renderTime.count() << " s, "
+              << mRecordedImages / renderTime.count() << " images per second" << std::endl;
+    FrameProfiler::printReport(std::cout, "benchmark");
+}
+
+void Engine::renderJob(const std::string& cfgPath, int from, int to, const std::string& outputName,
+                       const std::function<void(int)>& progress)
+{
+    // Relative paths of the configuration depend on the working directory
+    QFileInfo cfgInfo(QString::fromStdString(cfgPath));
+    QString cfgKey = QDir::currentPath() + "\n" + cfgInfo.absoluteFilePath();
+
+    // If the same configuration is still loaded, scene, trajectories and jerseys are ready
+    if(cfgKey != mLoadedConfigKey || cfgInfo.lastModified() != mLoadedConfigTime) {
+        mLoadedConfigKey = QString();
+        loadSettings(cfgPath);
+        updateTrajectories(mSequenceSettings.mFrameNumber);
+        mLoadedConfigKey = cfgKey;
+        mLoadedConfigTime = cfgInfo.lastModified();
+    }
+
+    // Job parameters replace the ones of the configuration for this job only
+    SequenceSettings cfgSettings = mSequenceSettings;
+    if(from < 0 || to < 0) {
+        from = cfgSettings.mStartTime;
+        to = cfgSettings.mEndTime;
+    }
+    if(!outputName.empty())
+        mSequenceSettings.mVideoOutputName = outputName;
+
+    mRecordingProgress = progress;
+    try {
+        saveVideo(from, to);
+    } catch(...) {
+        // State of the scene is unknown, so the next job reloads everything
+        mIsRecording = false;
+        mRecordingProgress = nullptr;
+        mSequenceSettings = cfgSettings;
+        mLoadedConfigKey = QString();
+        throw;
+    }
+    mRecordingProgress = nullptr;
+    mSequenceSettings = cfgSettings;
 }
 
 void Engine::livePlay()
@@ -385,6 +688,8 @@ void Engine::livePlay()
 
     int chunkStart = 0;
     mIsLivePlaying = true;
+    resetPlaybackStatistics();
+    mLiveStart = std::chrono::steady_clock::now();
     while(mIsLivePlaying) {
         updateTrajectories(windowSize);
         play(chunkStart, chunkStart + windowSize - 1);
@@ -393,6 +698,7 @@ void Engine::livePlay()
     }
 
     mIsLivePlaying = false;
+    printPlaybackStatistics("live playback");
 }
 
 const Court& Engine::getCourt() const
@@ -405,3 +711,8 @@ CameraWindow& Engine::getCameraWindow() const
     return *mCameraWindow;
 }
 
+PoseCache& Engine::getPoseCache() const
+{
+    return *mPoseCache;
+}
+
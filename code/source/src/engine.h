@@ -20,9 +20,13 @@
 #define ENGINE_H
 
 #include <memory>
+#include <chrono>
 #include <QApplication>
 //#include <X11/Xlib.h>
 #include <vector>
+#include <functional>
+#include <QString>
+#include <QDateTime>
 
 #include "camerawindow.h"
 #include "court.h"
@@ -30,9 +34,12 @@
 #include "affinetransformation.h"
 #include "sequencesettings.h"
 #include "avatarsfactory.h"
+#include "cameraview.h"
+#include "posecache.h"
 
 
 class AvatarsFactory;
+class JerseyAtlas;
 
 /**
  * @brief Controls the trajectory data and Irrlicht window (controller)
@@ -45,10 +52,10 @@ class Engine : public ITimeable
 
 public:
     /**
-     * Returns singleton instance of the engine
-     * @return instance of the engine
+     * Creates an engine without any scene. Each engine has its own window, scene and trajectories, so several
+     * engines can live in the same process.
      */
-    static Engine& getInstance();
+    Engine();
 
     /**
      * Releases memory for trajectories and affine transformation
@@ -64,12 +71,29 @@ public:
     int start(const QApplication& app, const std::vector<std::string>& args);
 
     /**
-     * Moves the players, the ball and the camera to the corresponding position/rotation
+     * Moves the players, the ball and the camera to the corresponding position/rotation, then displays the
+     * scene if anything changed
+     * @param time time index
+     * @see applyTime()
+     * @see redraw()
+     */
+    virtual void setTime(int time) override;
+
+    /**
+     * Moves the players, the ball and the camera to the corresponding position/rotation without displaying
+     * the scene, so that several changes can be displayed by a single redraw()
      * @param time time index
      * @see CameraWindow::setTime()
      * @see Court::setTime()
      */
-    virtual void setTime(int time) override;
+    void applyTime(int time);
+
+    /**
+     * Displays the scene if a body, the camera or the overlay changed since the last display
+     * @return true if the scene was drawn, false else
+     * @see CameraWindow::redraw()
+     */
+    bool redraw();
 
     /**
      * Returns court containing players and ball trajectories
@@ -84,10 +108,24 @@ public:
     CameraWindow& getCameraWindow() const;
 
     /**
-     * Quits program with status code 1, and displays error message
+     * Returns the poses of the animated meshes, shared by all the bodies of the window
+     * @return pose cache
+     */
+    PoseCache& getPoseCache() const;
+
+    /**
+     * Quits program with status code 1, and displays error message. In daemon mode, a std::runtime_error
+     * containing the message is thrown instead, so that only the current job fails
      * @param errorMessage error message to display
      */
-    void throwError(const stringw& errorMessage);
+    static void throwError(const stringw& errorMessage);
+
+    /**
+     * Makes throwError() throw a std::runtime_error on the calling thread, even outside daemon mode. Worker
+     * threads call it so that their errors are caught and reported by the thread waiting for them, instead
+     * of quitting the program under its feet
+     */
+    static void throwErrorsOnThisThread();
 
     /**
      * Returns sequence settings
@@ -97,7 +135,13 @@ public:
     const SequenceSettings& getSequenceSettings() const;
 
     /**
-     * Plays the scene in the 3D view according to the framerate and a play interval.
+     * Plays the scene in the 3D view according to the framerate, the playback rate and a play interval.
+     * Each displayed image has an absolute deadline on a monotonic clock, and advances the time by the
+     * playback rate. Above 1x, the bodies of every frame are still moved but only the last one is drawn.
+     * Below 1x, the images between two frames show interpolated positions. An image is not drawn if its
+     * deadline is already over, and it counts as dropped. An image drawn after its deadline counts as late.
+     * The last image is held until its deadline. During live playing, the images of all the chunks are on
+     * the timeline begun by livePlay(), so that loading a chunk does not shift the next images.
      * It is interrupted by stopPlaying()
      * @see stopPlaying()
      * @see saveVideo()
@@ -106,6 +150,12 @@ public:
      */
     void play(int from, int to);
 
+    /**
+     * Sets the speed of play(), which can be changed while playing. Live playing always uses 1x.
+     * @param rate frames of the sequence per displayed image, clamped to [0.25, 16]
+     */
+    void setPlaybackRate(double rate);
+
     /**
      * Called from EventManager to stop recording a video
      * @see saveVideo()
@@ -140,11 +190,23 @@ public:
      */
     const AffineTransformation& getAffineTransformation() const;
 
+    /**
+     * Records a video for the render daemon. The configuration is loaded only if it is not already the
+     * loaded one, otherwise the resident scene, trajectories and jersey textures are used directly.
+     * @see RenderDaemon
+     * @param cfgPath configuration file
+     * @param from begin frame, or -1 to use the sequence of the configuration
+     * @param to end frame, or -1 to use the sequence of the configuration
+     * @param outputName video file to write, or an empty string to use the one of the configuration
+     * @param progress called after each recorded frame with its index
+     */
+    void renderJob(const std::string& cfgPath, int from, int to, const std::string& outputName,
+                   const std::function<void(int)>& progress);
+
 
 private:
 
-    // Singletons denials
-    Engine();
+    // An engine owns its window and scene, it cannot be copied
     Engine& operator= (const Engine&);
     Engine(const Engine&);
 
@@ -163,7 +225,13 @@ private:
      * until the process is interrupted. During encoding, the method perodically checks whether new Irrlicht
      * window events have been thrown. If so, the event manager processes them and is therefore capable
      * of interrupting the process by calling stopRecording().
+     * The main camera is recorded to the output of the sequence settings, and each additional camera to its
+     * own output.
+     * If checkpoints are enabled in the sequence settings, the video is recorded in segments listed in a
+     * RecordingManifest, which are assembled once the whole sequence has been processed. An interrupted
+     * or crashed recording then resumes after its last finished segment.
      * @see CameraSettings
+     * @see RecordingManifest
      * @see EventManager
      * @see stopRecording()
      * @param from begin frame
@@ -172,13 +240,64 @@ private:
     void saveVideo(int from, int to);
 
     /**
-     * Retrieves data from the streams and plays it in real time.
-     * Is interrupted by stopLivePlaying();
+     * Renders and encodes a range of frames into video files, until the end of the range or until
+     * stopRecording() is called. Images are at the output frame rate, those between two frames showing
+     * interpolated positions. The court is moved once per image, then the scene is rendered once with
+     * the main camera and once with each additional camera.
+     * @param from begin frame
+     * @param to end frame
+     * @param fileNames video files to write: the one of the main camera, then one per additional camera
+     * @param converter converter holding the planes of recorded frames
+     * @return true if all the frames of the range have been written. The number of images written for each
+     * camera is kept in mRecordedImages.
+     */
+    bool recordRange(int from, int to, const std::vector<std::string>& fileNames, YuvConverter& converter);
+
+    /**
+     * Measures the throughput of the whole pipeline: loading of the trajectories with their kinematics, then
+     * rendering, readback and conversion of each frame for every camera. Frames are discarded by null
+     * sinks. Prints the frame rate and the duration of each stage.
+     * @see FrameProfiler
+     * @param from begin frame
+     * @param to end frame
+     */
+    void runBenchmark(int from, int to);
+
+    /**
+     * Retrieves data from the streams and plays it in real time, chunk by chunk from frame 0, on a single
+     * timeline of image deadlines. Is interrupted by stopLivePlaying();
      * @see saveVideo()
      * @see stopLivePlaying();
      */
     void livePlay();
 
+    /**
+     * Applies every frame after the last applied one up to the given time, then moves the players, the ball
+     * and the camera between two frames if the time is fractional
+     * @param time fractional time index, not before the last applied frame
+     * @param appliedFrame last applied frame, updated by the method
+     */
+    void advanceTo(double time, int& appliedFrame);
+
+    /**
+     * Moves the players, the ball and the camera between two frames, without displaying the scene
+     * @param time fractional time index
+     * @see Court::setInterpolatedTime()
+     * @see CameraWindow::setInterpolatedTime()
+     */
+    void applyInterpolatedTime(double time);
+
+    /**
+     * Clears the counts of played, late and dropped frames, and the frame profile
+     */
+    void resetPlaybackStatistics();
+
+    /**
+     * Prints the counts of played, late and dropped frames, then the frame profile
+     * @param title name of the playback
+     */
+    void printPlaybackStatistics(const std::string& title) const;
+
 
 
 
@@ -188,17 +307,40 @@ private:
     std::unique_ptr<AffineTransformation> mTransformation;
 
     int mCurrentFrame;
+    std::unique_ptr<PoseCache> mPoseCache;
     std::unique_ptr<Court> mCourt;
+    std::unique_ptr<JerseyAtlas> mJerseyAtlas;
     std::unique_ptr<CameraWindow> mCameraWindow;
 
+    // Camera stream is null when the camera trajectory is keyframed, and so are the ones of additional cameras
     std::unique_ptr<std::istream> mCameraStream;
     std::unique_ptr<std::istream> mPlayerStream;
     std::unique_ptr<std::istream> mBallStream;
 
+    // Additional cameras recorded to their own outputs, and their trajectory streams
+    std::vector<std::unique_ptr<CameraView>> mViews;
+    std::vector<std::unique_ptr<std::istream>> mViewStreams;
+
     // Video saving interruption flag
     bool mIsRecording;
+    std::function<void(int)> mRecordingProgress;
+    // Images written for each camera by the last recorded range
+    int mRecordedImages;
+
     bool mIsPlaying;
     bool mIsLivePlaying;
+    // Time at which live playing displays frame 0
+    std::chrono::steady_clock::time_point mLiveStart;
+    double mPlaybackRate;
+
+    // Images of the current playback
+    int mPlayedFrames;
+    int mLateFrames;
+    int mDroppedFrames;
+
+    // Daemon state: configuration already loaded
+    QString mLoadedConfigKey;
+    QDateTime mLoadedConfigTime;
 
 };
 
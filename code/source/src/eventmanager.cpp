@@ -23,12 +23,15 @@
 
 using namespace irr;
 
+EventManager::EventManager(Engine& engine) : mEngine(engine)
+{
+}
+
 bool EventManager::OnEvent(const SEvent& event) {
     if(event.EventType == EET_KEY_INPUT_EVENT)
     {
         if(event.KeyInput.Key == KEY_ESCAPE) {
-            Engine& e = Engine::getInstance();
-            e.stopRecording();
+            mEngine.stopRecording();
             return true;
         }
     }
@@ -23,6 +23,8 @@
 
 using namespace irr;
 
+class Engine;
+
 /**
  * @brief Irrlicht window event manager
  *
@@ -32,12 +34,22 @@ using namespace irr;
 class EventManager : public IEventReceiver {
 
 public:
+
+    /**
+     * Creates an event manager for the window of an engine
+     * @param engine engine whose recording can be interrupted
+     */
+    explicit EventManager(Engine& engine);
+
     /**
      * Listens to keyboard events. Calls Engine::stopRecording() if ESCAPE key is pressed.
      * @param event event to process
      * @return whether event has been processed
      */
     virtual bool OnEvent(const SEvent& event);
+
+private:
+    Engine& mEngine;
 };
 
 #endif // EVENTMANAGER_H
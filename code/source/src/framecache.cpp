@@ -0,0 +1,76 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "framecache.h"
+
+FrameCache::FrameCache(u32 capacity)
+{
+    mCapacity = capacity;
+    mSize = 0;
+}
+
+FrameCache::~FrameCache()
+{
+    clear();
+}
+
+IImage* FrameCache::get(int frame, const vector3df& position, const vector3df& rotation)
+{
+    for(auto i = mEntries.begin(); i != mEntries.end(); ++i) {
+        if(i->mFrame == frame && i->mPosition == position && i->mRotation == rotation) {
+            mEntries.splice(mEntries.begin(), mEntries, i);
+            return i->mImage;
+        }
+    }
+
+    return nullptr;
+}
+
+void FrameCache::insert(int frame, const vector3df& position, const vector3df& rotation, IImage* image)
+{
+    // An image larger than the whole cache would only evict the others
+    u32 imageSize = image->getImageDataSizeInBytes();
+    if(imageSize > mCapacity)
+        return;
+
+    image->grab();
+    Entry entry = { frame, position, rotation, image };
+    mEntries.push_front(entry);
+    mSize += imageSize;
+
+    while(mSize > mCapacity) {
+        IImage* oldest = mEntries.back().mImage;
+        mSize -= oldest->getImageDataSizeInBytes();
+        oldest->drop();
+        mEntries.pop_back();
+    }
+}
+
+void FrameCache::clear()
+{
+    for(auto i = mEntries.begin(); i != mEntries.end(); ++i) {
+        i->mImage->drop();
+    }
+    mEntries.clear();
+    mSize = 0;
+}
+
+u32 FrameCache::getSize() const
+{
+    return mSize;
+}
@@ -0,0 +1,103 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAMECACHE_H
+#define FRAMECACHE_H
+
+#include <list>
+#include <irrlicht.h>
+
+using namespace irr;
+using namespace irr::core;
+using namespace irr::video;
+
+/**
+ * @brief Least recently used images of the window, for scrubbing
+ *
+ * Moving back and forth on the timeline displays the same frames again. The cache keeps the images already
+ * displayed, keyed by frame index and camera pose, so that they can be shown again without drawing the scene.
+ * The images stay in system memory, and the least recently used ones are released when their total size goes
+ * over the capacity.
+ */
+class FrameCache
+{
+
+public:
+
+    /**
+     * Creates an empty cache
+     * @param capacity maximum size of the images in bytes
+     */
+    explicit FrameCache(u32 capacity);
+
+    /**
+     * Releases the images
+     */
+    ~FrameCache();
+
+    /**
+     * Returns the image of a frame seen from a camera pose, and marks it as the most recently used
+     * @param frame frame index
+     * @param position virtual position of the camera
+     * @param rotation rotation of the camera
+     * @return image owned by the cache, or nullptr if there is none
+     */
+    IImage* get(int frame, const vector3df& position, const vector3df& rotation);
+
+    /**
+     * References the image of a frame seen from a camera pose, then releases the least recently used images
+     * until the cache fits in its capacity
+     * @param frame frame index
+     * @param position virtual position of the camera
+     * @param rotation rotation of the camera
+     * @param image image, grabbed by the cache
+     */
+    void insert(int frame, const vector3df& position, const vector3df& rotation, IImage* image);
+
+    /**
+     * Releases all the images, for instance when the scene settings change
+     */
+    void clear();
+
+    /**
+     * Returns total size of the images in the cache
+     * @return size in bytes
+     */
+    u32 getSize() const;
+
+private:
+
+    FrameCache& operator= (const FrameCache&);
+    FrameCache(const FrameCache&);
+
+    struct Entry
+    {
+        int mFrame;
+        vector3df mPosition;
+        vector3df mRotation;
+        IImage* mImage;
+    };
+
+    // Most recently used first. A linear search is enough for the few dozens of images that fit in memory.
+    std::list<Entry> mEntries;
+
+    u32 mCapacity;
+    u32 mSize;
+};
+
+#endif // FRAMECACHE_H
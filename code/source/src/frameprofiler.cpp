@@ -0,0 +1,159 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <mutex>
+#include <algorithm>
+#include <iomanip>
+#include "frameprofiler.h"
+
+namespace
+{
+    // Protects the list of collectors, not the samples which belong to their thread
+    std::mutex collectorsMutex;
+
+    const char* stageNames[] = {
+        "ingestion", "kinematics", "court", "trail", "draw", "gui", "readback", "conversion", "encoding"
+    };
+}
+
+FrameProfiler::ScopedTimer::ScopedTimer(Stage stage)
+    : mStage(stage), mBegin(std::chrono::steady_clock::now())
+{
+}
+
+FrameProfiler::ScopedTimer::~ScopedTimer()
+{
+    std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - mBegin;
+    addSample(mStage, elapsed.count());
+}
+
+void FrameProfiler::addSample(Stage stage, float milliseconds)
+{
+    getCollector().mSamples[stage].push_back(milliseconds);
+}
+
+void FrameProfiler::reset()
+{
+    std::lock_guard<std::mutex> lock(collectorsMutex);
+    // Encoders of previous recordings would otherwise accumulate in long-running processes
+    auto& collectors = getCollectors();
+    collectors.erase(std::remove_if(collectors.begin(), collectors.end(),
+                                    [](const std::unique_ptr<Collector>& collector) {
+                                        return collector->mIsThreadFinished;
+                                    }),
+                     collectors.end());
+    for(auto& collector : collectors) {
+        for(auto& samples : collector->mSamples)
+            samples.clear();
+    }
+}
+
+FrameProfiler::Statistics FrameProfiler::computeRecentStatistics(Stage stage, unsigned int nbRecent)
+{
+    auto& samples = getCollector().mSamples[stage];
+    unsigned int first = samples.size() > nbRecent ? samples.size() - nbRecent : 0;
+    std::vector<float> recent(samples.begin() + first, samples.end());
+    return computeStatistics(recent);
+}
+
+void FrameProfiler::printReport(std::ostream& out, const std::string& title)
+{
+    std::lock_guard<std::mutex> lock(collectorsMutex);
+
+    out << "Frame profile of " << title << " (milliseconds)" << std::endl;
+    out << std::left << std::setw(12) << "stage" << std::right
+        << std::setw(10) << "count" << std::setw(10) << "p50" << std::setw(10) << "p95"
+        << std::setw(10) << "p99" << std::setw(10) << "max" << std::endl;
+
+    for(int stage = 0; stage < STAGE_COUNT; ++stage) {
+        std::vector<float> samples;
+        for(auto& collector : getCollectors()) {
+            auto& threadSamples = collector->mSamples[stage];
+            samples.insert(samples.end(), threadSamples.begin(), threadSamples.end());
+        }
+        if(samples.empty())
+            continue;
+
+        Statistics stats = computeStatistics(samples);
+        out << std::left << std::setw(12) << stageNames[stage] << std::right << std::fixed << std::setprecision(3)
+            << std::setw(10) << stats.mCount << std::setw(10) << stats.mMedian << std::setw(10) << stats.mP95
+            << std::setw(10) << stats.mP99 << std::setw(10) << stats.mMax << std::endl;
+    }
+    out.unsetf(std::ios_base::floatfield);
+}
+
+const char* FrameProfiler::getStageName(Stage stage)
+{
+    return stageNames[stage];
+}
+
+FrameProfiler::Collector& FrameProfiler::getCollector()
+{
+    // Marks the collector when its thread exits, so that reset() can drop it
+    struct CollectorOwner
+    {
+        Collector* mCollector;
+
+        ~CollectorOwner()
+        {
+            if(mCollector == nullptr)
+                return;
+            std::lock_guard<std::mutex> lock(collectorsMutex);
+            mCollector->mIsThreadFinished = true;
+        }
+    };
+
+    // Each thread registers its collector once, then adds samples without locking
+    thread_local CollectorOwner owner = { nullptr };
+    if(owner.mCollector == nullptr) {
+        Collector* collector = new Collector();
+        collector->mIsThreadFinished = false;
+        std::lock_guard<std::mutex> lock(collectorsMutex);
+        getCollectors().push_back(std::unique_ptr<Collector>(collector));
+        owner.mCollector = collector;
+    }
+    return *owner.mCollector;
+}
+
+std::vector<std::unique_ptr<FrameProfiler::Collector>>& FrameProfiler::getCollectors()
+{
+    // Collectors outlive their thread, so that samples of finished encoders are reported
+    static std::vector<std::unique_ptr<Collector>> collectors;
+    return collectors;
+}
+
+FrameProfiler::Statistics FrameProfiler::computeStatistics(std::vector<float>& samples)
+{
+    Statistics stats = { 0, 0, 0, 0, 0 };
+    if(samples.empty())
+        return stats;
+
+    // Nearest-rank percentiles
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](float p) {
+        unsigned int rank = (unsigned int) (p * samples.size());
+        return samples[std::min(rank, (unsigned int) samples.size() - 1)];
+    };
+
+    stats.mCount = samples.size();
+    stats.mMedian = percentile(0.5f);
+    stats.mP95 = percentile(0.95f);
+    stats.mP99 = percentile(0.99f);
+    stats.mMax = samples.back();
+    return stats;
+}
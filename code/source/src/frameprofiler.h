@@ -0,0 +1,147 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <ostream>
+#include <chrono>
+
+/**
+ * @brief Collects the durations of the stages of each frame and reports their distribution
+ *
+ * Class only with static methods. Each thread appends its samples to its own collector without locking, so
+ * timers can be left in the rendering loop and in the encoding threads. Collectors of finished threads are
+ * kept until the next reset(), so that their samples appear in the report.
+ */
+class FrameProfiler
+{
+
+public:
+
+    /**
+     * Measured stages. Ingestion and kinematics are measured once per chunk of trajectories, the other stages
+     * once per frame. Trail building is measured inside the court update, so a frame may count it twice.
+     */
+    enum Stage
+    {
+        STAGE_INGESTION,
+        STAGE_KINEMATICS,
+        STAGE_COURT,
+        STAGE_TRAIL,
+        STAGE_DRAW,
+        STAGE_GUI,
+        STAGE_READBACK,
+        STAGE_CONVERSION,
+        STAGE_ENCODING,
+        STAGE_COUNT
+    };
+
+    /**
+     * Distribution of the durations of a stage, in milliseconds
+     */
+    struct Statistics
+    {
+        int mCount;
+        float mMedian;
+        float mP95;
+        float mP99;
+        float mMax;
+    };
+
+    /**
+     * @brief Measures the duration of a stage from its creation to its destruction
+     */
+    class ScopedTimer
+    {
+
+    public:
+
+        /**
+         * Starts measuring a stage
+         * @param stage measured stage
+         */
+        explicit ScopedTimer(Stage stage);
+
+        /**
+         * Adds the elapsed time to the collector of the thread
+         */
+        ~ScopedTimer();
+
+    private:
+
+        ScopedTimer& operator= (const ScopedTimer&);
+        ScopedTimer(const ScopedTimer&);
+
+        Stage mStage;
+        std::chrono::steady_clock::time_point mBegin;
+    };
+
+    /**
+     * Adds a duration to the collector of the calling thread
+     * @param stage measured stage
+     * @param milliseconds duration
+     */
+    static void addSample(Stage stage, float milliseconds);
+
+    /**
+     * Removes the samples of all the threads. Must not be called while other threads are measuring.
+     */
+    static void reset();
+
+    /**
+     * Computes the distribution of the last samples of the calling thread, for a display during playback
+     * @param stage measured stage
+     * @param nbRecent maximum number of samples, the newest ones
+     * @return statistics, with a count of 0 if the stage was not measured
+     */
+    static Statistics computeRecentStatistics(Stage stage, unsigned int nbRecent);
+
+    /**
+     * Prints the distribution of each measured stage with the samples of all the threads. Must not be called
+     * while other threads are measuring.
+     * @param out output stream
+     * @param title name of the measured run
+     */
+    static void printReport(std::ostream& out, const std::string& title);
+
+    /**
+     * Returns name of a stage, as displayed in reports
+     * @param stage stage
+     * @return name
+     */
+    static const char* getStageName(Stage stage);
+
+private:
+
+    struct Collector
+    {
+        std::vector<float> mSamples[STAGE_COUNT];
+        bool mIsThreadFinished;
+    };
+
+    static Collector& getCollector();
+    static std::vector<std::unique_ptr<Collector>>& getCollectors();
+    static Statistics computeStatistics(std::vector<float>& samples);
+
+};
+
+#endif // FRAMEPROFILER_H
@@ -0,0 +1,178 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <functional>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <irrlicht.h>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QString>
+#include "camerawindow.h"
+#include "engine.h"
+#include "player.h"
+#include "jerseyatlas.h"
+
+using namespace irr;
+using namespace irr::core;
+using namespace irr::video;
+
+JerseyAtlas::JerseyAtlas(Engine& engine, const std::string& cachePath)
+    : mEngine(engine), mCachePath(cachePath), mTexture(nullptr), mColumnCount(0), mRowCount(0)
+{
+
+}
+
+JerseyAtlas::~JerseyAtlas()
+{
+    if(mTexture != nullptr)
+        mEngine.getCameraWindow().getDriver()->removeTexture(mTexture);
+}
+
+void JerseyAtlas::bake(const PlayerMap& players)
+{
+    if(players.empty())
+        return;
+
+    // All player textures have the size given in the configuration, cells are laid out in a square grid
+    mCellSize = players.begin()->second->getPlayerSettings().mTextureSize;
+    mColumnCount = (int) std::ceil(std::sqrt((double) players.size()));
+    mRowCount = (players.size() + mColumnCount - 1) / mColumnCount;
+    dimension2d<u32> atlasSize(mCellSize.Width * mColumnCount, mCellSize.Height * mRowCount);
+
+    // Name of the atlas changes with anything drawn in it
+    std::ostringstream name;
+    name << "jerseys_" << std::hex << std::setw(16) << std::setfill('0')
+         << std::hash<std::string>()(describe(players)) << ".png";
+
+    auto driver = mEngine.getCameraWindow().getDriver();
+    if(!mCachePath.empty()) {
+        io::path cachedPath = (mCachePath + "/" + name.str()).c_str();
+        if(QFileInfo(QString::fromUtf8(cachedPath.c_str())).exists()) {
+            // Mipmaps would mix neighbouring cells for distant players, and a drawn atlas has none
+            bool isMipMapped = driver->getTextureCreationFlag(ETCF_CREATE_MIP_MAPS);
+            driver->setTextureCreationFlag(ETCF_CREATE_MIP_MAPS, false);
+            mTexture = driver->getTexture(cachedPath);
+            driver->setTextureCreationFlag(ETCF_CREATE_MIP_MAPS, isMipMapped);
+            // An atlas of another size is not usable, so it is drawn again
+            if(mTexture != nullptr && mTexture->getOriginalSize() != atlasSize) {
+                driver->removeTexture(mTexture);
+                mTexture = nullptr;
+            }
+        }
+
+        if(mTexture == nullptr) {
+            mTexture = draw(players, name.str().c_str());
+
+            // Render target is read back once to be saved
+            IImage* image = driver->createImage(mTexture, position2di(0, 0), atlasSize);
+            if(image != nullptr) {
+                driver->writeImageToFile(image, cachedPath);
+                image->drop();
+            }
+        }
+    } else {
+        mTexture = draw(players, name.str().c_str());
+    }
+
+    // Each player shows its own cell of the atlas
+    int index = 0;
+    for(auto i = players.begin(); i != players.end(); ++i, ++index) {
+        recti cell = getCell(index);
+        matrix4 textureMatrix;
+        textureMatrix.setTextureScale((f32) mCellSize.Width / atlasSize.Width,
+                                      (f32) mCellSize.Height / atlasSize.Height);
+        textureMatrix.setTextureTranslate((f32) cell.UpperLeftCorner.X / atlasSize.Width,
+                                          (f32) cell.UpperLeftCorner.Y / atlasSize.Height);
+        i->second->setJerseyTexture(mTexture, textureMatrix);
+    }
+}
+
+ITexture* JerseyAtlas::getTexture() const
+{
+    return mTexture;
+}
+
+std::string JerseyAtlas::describe(const PlayerMap& players) const
+{
+    auto& cameraSettings = mEngine.getCameraWindow().getSettings();
+
+    std::ostringstream description;
+    auto modificationTime = [](const char* path) {
+        return QFileInfo(QString::fromUtf8(path)).lastModified().toTime_t();
+    };
+    description << cameraSettings.mFontJerseyPath << " " << modificationTime(cameraSettings.mFontJerseyPath)
+                << " " << cameraSettings.mJerseyTextColor.color << "\n";
+
+    for(auto i = players.begin(); i != players.end(); ++i) {
+        const Player& player = *i->second;
+        io::path texturePath = player.getTexture()->getName();
+        auto& rect = player.getPlayerSettings().mJerseyTextRect;
+        description << texturePath.c_str() << " " << modificationTime(texturePath.c_str()) << " "
+                    << player.getPlayerSettings().mJerseyNumber << " "
+                    << player.getPlayerSettings().mTextureSize.Width << " "
+                    << player.getPlayerSettings().mTextureSize.Height << " "
+                    << rect.UpperLeftCorner.X << " " << rect.UpperLeftCorner.Y << " "
+                    << rect.LowerRightCorner.X << " " << rect.LowerRightCorner.Y << "\n";
+    }
+
+    return description.str();
+}
+
+ITexture* JerseyAtlas::draw(const PlayerMap& players, const io::path& name)
+{
+    CameraWindow& cam = mEngine.getCameraWindow();
+    auto driver = cam.getDriver();
+    dimension2d<u32> atlasSize(mCellSize.Width * mColumnCount, mCellSize.Height * mRowCount);
+
+    ITexture* atlas = driver->addRenderTargetTexture(atlasSize, name);
+
+    driver->beginScene(true, true, cam.getSettings().mBgColor);
+    // Now we draw on the atlas instead of window
+    driver->setRenderTarget(atlas, true, true, SColor(255, 0, 0, 0));
+
+    int index = 0;
+    for(auto i = players.begin(); i != players.end(); ++i, ++index) {
+        const Player& plr = *i->second;
+        recti cell = getCell(index);
+
+        // Draw actual player texture, with its color but without jersey number, in the cell
+        auto texture = plr.getTexture();
+        driver->setMaterial(driver->getMaterial2D());
+        driver->draw2DImage(texture, cell, recti(position2di(0, 0), texture->getOriginalSize()));
+
+        // Draw jersey number over it
+        driver->setMaterial(driver->getMaterial2D());
+        cam.getJerseyFont()->draw(plr.getJerseyText(),
+                                  plr.getPlayerSettings().mJerseyTextRect + cell.UpperLeftCorner,
+                                  cam.getSettings().mJerseyTextColor, true, true, &cell);
+    }
+
+    // We go back to window (necessary to be able to switch, see API)
+    driver->setRenderTarget(0, true, true, cam.getSettings().mBgColor);
+    driver->endScene();
+
+    return atlas;
+}
+
+recti JerseyAtlas::getCell(int index) const
+{
+    position2di corner((index % mColumnCount) * mCellSize.Width, (index / mColumnCount) * mCellSize.Height);
+    return recti(corner, mCellSize);
+}
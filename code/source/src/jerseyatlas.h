@@ -0,0 +1,106 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JERSEYATLAS_H
+#define JERSEYATLAS_H
+
+#include <string>
+#include <irrlicht.h>
+#include "court.h"
+
+using namespace irr;
+using namespace irr::core;
+using namespace irr::video;
+
+class Engine;
+
+/**
+ * @brief Single texture holding the jerseys of all the players
+ *
+ * Player textures with their jersey number are drawn side by side in one texture, and each player shows its
+ * own cell through a texture matrix. Players then share one texture instead of one render target each, and
+ * jerseys are drawn once when the court is loaded, not on the first frame. When a cache directory is given,
+ * the atlas is saved as a PNG image named after the team textures, numbers, font and color it was drawn
+ * from, so that the next runs load it instead of drawing it.
+ */
+class JerseyAtlas
+{
+
+public:
+
+    /**
+     * Creates an empty atlas
+     * @param engine engine whose window draws the jerseys
+     * @param cachePath directory where atlases are saved, or empty string to disable the cache
+     */
+    JerseyAtlas(Engine& engine, const std::string& cachePath);
+
+    /**
+     * Releases the atlas texture
+     */
+    ~JerseyAtlas();
+
+    /**
+     * Loads or draws the jerseys of the players, and gives each player its cell of the atlas
+     * @param players players of the court
+     */
+    void bake(const PlayerMap& players);
+
+    /**
+     * Returns the atlas texture
+     * @return texture, or nullptr before bake()
+     */
+    ITexture* getTexture() const;
+
+    /**
+     * Describes everything drawn in the atlas, including modification times of the files it comes from
+     * @param players players of the court
+     * @return description of the atlas
+     */
+    std::string describe(const PlayerMap& players) const;
+
+private:
+
+    JerseyAtlas& operator= (const JerseyAtlas&);
+    JerseyAtlas(const JerseyAtlas&);
+
+    /**
+     * Draws the jerseys in a new render target texture
+     * @param players players of the court
+     * @param name name of the texture
+     * @return atlas texture
+     */
+    ITexture* draw(const PlayerMap& players, const io::path& name);
+
+    /**
+     * Returns the area of a player in the atlas
+     * @param index rank of the player
+     * @return cell in pixels
+     */
+    recti getCell(int index) const;
+
+    Engine& mEngine;
+    std::string mCachePath;
+
+    ITexture* mTexture;
+    dimension2d<u32> mCellSize;
+    int mColumnCount;
+    int mRowCount;
+};
+
+#endif // JERSEYATLAS_H
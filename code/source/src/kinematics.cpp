@@ -0,0 +1,120 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "science.h"
+#include "kinematics.h"
+
+void Kinematics::storeSpeed(const VectorSequence& positions, int from, int derivativeInterval, int framerate,
+                            VectorSequence& speeds)
+{
+    // Store uncomputable values
+    int lastNecessaryIndex = derivativeInterval - 1;
+    if(from <= lastNecessaryIndex) {
+        for(int i = 0; i <= lastNecessaryIndex; ++i) {
+            speeds.set(i, vector3df(0, 0, 0));
+        }
+    }
+
+    int begin = Science::max(from, derivativeInterval);
+    for(int i = begin; i <= positions.getEnd(); ++i) {
+        speeds.set(i, ((float)framerate) * (positions.get(i) - positions.get(i - derivativeInterval))
+                                / derivativeInterval);
+    }
+}
+
+void Kinematics::storeSmoothed(const VectorSequence &values, int from, int nbPointsAverager, VectorSequence &smoothed)
+{
+    // Store uncomputable values
+    int lastNecessaryIndex = nbPointsAverager - 2;
+    if(from <= lastNecessaryIndex) {
+        for(int i = 0; i <= lastNecessaryIndex; ++i) {
+            smoothed.set(i, vector3df(0, 0, 0));
+        }
+    }
+
+    int begin = Science::max(from, nbPointsAverager - 1);
+    for(int i = begin; i <= values.getEnd(); ++i) {
+        vector3df sum(0, 0, 0);
+        for(int j = 0; j < nbPointsAverager; ++j) {
+            sum += values.get(i - j);
+        }
+        smoothed.set(i, sum / nbPointsAverager);
+    }
+}
+
+std::map<int, int> Kinematics::computeAnimations(const std::map<int, float>& timeToSpeed,
+                                                 const std::map<AnimationAction, ActionSettings>& actions,
+                                                 int ratio, const std::map<int, int>& timeToPreviousFrame)
+{
+    // Deduce animation from real speed
+    std::map < int, AnimationAction > frameAction;
+    for(std::map<int, float>::const_iterator s = timeToSpeed.begin(); s != timeToSpeed.end(); ++s) {
+        int index = s->first;
+        float magnitude = s->second;
+        if(magnitude < actions.at(AnimationAction::Walk).mThreshold) {
+            frameAction[index] = AnimationAction::Stand;
+        }
+        else if(magnitude < actions.at(AnimationAction::Run).mThreshold) {
+            frameAction[index] = AnimationAction::Walk;
+        }
+        else {
+            frameAction[index] = AnimationAction::Run;
+        }
+    }
+
+    // Initialize state and animation counters
+    AnimationAction currentAction = frameAction.begin()->second;
+
+    int fcount = frameAction.begin()->first;
+    int fanim = timeToPreviousFrame.find(fcount - 1) != timeToPreviousFrame.end() ?
+                    timeToPreviousFrame.at(fcount - 1) : actions.at(currentAction).mBegin;
+
+    // Store the right animation frames
+    std::map<int, int> timeToAnimFrame;
+    for(std::map<int, AnimationAction>::iterator a = frameAction.begin(); a != frameAction.end(); ++a) {
+        int index = a->first;
+        AnimationAction newAction = a->second;
+
+        if(newAction == currentAction) {
+            // If the action remains the same, we switch to next animation frame
+            ++fcount;
+
+            // If the current animation frame has been repeated sufficiently to keep fluency,
+            // we switch to next animation frame
+            if(fcount >= ratio) {
+                fcount = 0;
+                ++fanim;
+            }
+
+            // If we reach the end of the animation we go back to its beginning
+            if(fanim > actions.at(currentAction).mEnd) {
+                fcount = 0;
+                fanim = actions.at(currentAction).mBegin;
+            }
+        } else {
+            // If animation state changes, we go to the beginning of new state
+            fcount = 0;
+            fanim = actions.at(newAction).mBegin;
+        }
+
+        currentAction = newAction;
+        timeToAnimFrame[index] = fanim;
+    }
+
+    return timeToAnimFrame;
+}
@@ -0,0 +1,76 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINEMATICS_H
+#define KINEMATICS_H
+
+#include <map>
+#include <irrlicht.h>
+#include "vectorsequence.h"
+#include "playersettings.h"
+
+using namespace irr;
+using namespace irr::core;
+
+/**
+ * Class only with static methods, to derive speeds and animations from trajectories. Moveable and Player
+ * store the results, so that these computations do not need an engine.
+ */
+class Kinematics
+{
+
+public:
+
+    /**
+     * Computes the speed vectors of a position sequence, from a start index to its end. Speeds before the
+     * first computable one are set to 0.
+     * @param positions position sequence
+     * @param from start index
+     * @param derivativeInterval number of frames between the two positions of a derivative
+     * @param framerate frame rate of the sequence
+     * @param speeds sequence receiving the speed vectors
+     */
+    static void storeSpeed(const VectorSequence& positions, int from, int derivativeInterval, int framerate,
+                           VectorSequence& speeds);
+
+    /**
+     * Computes the moving average of a sequence, from a start index to its end. Values before the first
+     * computable one are set to 0.
+     * @param values sequence to average
+     * @param from start index
+     * @param nbPointsAverager number of points of the averager
+     * @param smoothed sequence receiving the averages
+     */
+    static void storeSmoothed(const VectorSequence& values, int from, int nbPointsAverager, VectorSequence& smoothed);
+
+    /**
+     * Computes the 3D model frames of a player from its speeds. The action of each frame is chosen from the
+     * speed thresholds, and each animation frame is repeated to keep the animation at its own frame rate.
+     * @param timeToSpeed map from time to speed magnitude, which must not be empty
+     * @param actions animation actions with their thresholds and frames
+     * @param ratio number of times each animation frame is repeated
+     * @param timeToPreviousFrame 3D model frames already computed, to continue the animation
+     * @return map from time to 3D model frame index
+     */
+    static std::map<int, int> computeAnimations(const std::map<int, float>& timeToSpeed,
+                                                const std::map<AnimationAction, ActionSettings>& actions,
+                                                int ratio, const std::map<int, int>& timeToPreviousFrame);
+
+};
+
+#endif // KINEMATICS_H
@@ -37,9 +37,9 @@ int main(int argc, char *argv[])
     for(int i = 0; i < argc; ++i)
         args.push_back(argv[i]);
 
-    // Engine object handles the application
-    Engine& e = Engine::getInstance();
     QApplication app(argc, argv);
 
-    return e.start(app, args);
+    // Engine object handles the application
+    Engine engine;
+    return engine.start(app, args);
 }
@@ -22,6 +22,7 @@
 #include <QKeyEvent>
 #include <QTime>
 #include <QThread>
+#include <QTimer>
 
 #include "camerawindow.h"
 #include "engine.h"
@@ -33,15 +34,13 @@
 using namespace irr;
 using namespace core;
 
-MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent),
-            mUi(new Ui::MainWindow)
+MainWindow::MainWindow(Engine& engine, QWidget *parent) : QMainWindow(parent),
+            mEngine(engine), mUi(new Ui::MainWindow), mIsRedrawScheduled(false)
 {
     // Qt window title
     mUi->setupUi(this);
     this->setWindowTitle("Avatars controller");
 
-    Engine& engine = Engine::getInstance();
-
     // Initialize sequence
     int frameNumber = engine.getSequenceSettings().mFrameNumber;
 
@@ -54,7 +53,7 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent),
     mUi->toVideo->setMaximum(frameNumber - 1);
 
     // Sets fpsScale of FPS camera
-    int fpsScale = Engine::getInstance().getCameraWindow().getSettings().mFpsScale;
+    int fpsScale = mEngine.getCameraWindow().getSettings().mFpsScale;
     mUi->fpsScale->setValue(fpsScale);
 
     // Initialize frame navigation widgets
@@ -77,7 +76,7 @@ void MainWindow::setFpsScale(double val)
 
 void MainWindow::updateWidgets()
 {
-    CameraWindow& cam = Engine::getInstance().getCameraWindow();
+    CameraWindow& cam = mEngine.getCameraWindow();
 
     // Update position widgets
     auto position = cam.getRealPosition();
@@ -96,6 +95,8 @@ void MainWindow::blockAnimationTab()
 {
     mUi->useTrajectoryFile->setChecked(false);
     blockAnimationSignals(true);
+    // Live playing keeps up with the streams
+    modifyBlockingState(mUi->playbackRate, true);
 }
 
 void MainWindow::setFollowTrajectory(bool isFollowing)
@@ -105,56 +106,56 @@ void MainWindow::setFollowTrajectory(bool isFollowing)
 
 void MainWindow::setCameraRealPosition(const vector3df& vector)
 {
-    CameraWindow& cam = Engine::getInstance().getCameraWindow();
+    CameraWindow& cam = mEngine.getCameraWindow();
     cam.setRealPosition(vector);
-    cam.updateScene();
+    scheduleRedraw();
 }
 
 void MainWindow::on_xPos_valueChanged(double arg1)
 {
-    auto currentPosition = Engine::getInstance().getCameraWindow().getRealPosition();
+    auto currentPosition = mEngine.getCameraWindow().getRealPosition();
     currentPosition.X = (float)arg1;
     setCameraRealPosition(currentPosition);
 }
 
 void MainWindow::on_yPos_valueChanged(double arg1)
 {
-    auto currentPosition = Engine::getInstance().getCameraWindow().getRealPosition();
+    auto currentPosition = mEngine.getCameraWindow().getRealPosition();
     currentPosition.Y = (float)arg1;
     setCameraRealPosition(currentPosition);
 }
 
 void MainWindow::on_zPos_valueChanged(double arg1)
 {
-    auto currentPosition = Engine::getInstance().getCameraWindow().getRealPosition();
+    auto currentPosition = mEngine.getCameraWindow().getRealPosition();
     currentPosition.Z = (float)arg1;
     setCameraRealPosition(currentPosition);
 }
 
 void MainWindow::setCameraRotation(const vector3df& vector)
 {
-    CameraWindow& cam = Engine::getInstance().getCameraWindow();
+    CameraWindow& cam = mEngine.getCameraWindow();
     cam.setRotation(vector);
-    cam.updateScene();
+    scheduleRedraw();
 }
 
 void MainWindow::on_xRot_valueChanged(double arg1)
 {
-    auto currentRotation = Engine::getInstance().getCameraWindow().getRotation();
+    auto currentRotation = mEngine.getCameraWindow().getRotation();
     currentRotation.X = (float)arg1;
     setCameraRotation(currentRotation);
 }
 
 void MainWindow::on_yRot_valueChanged(double arg1)
 {
-    auto currentRotation = Engine::getInstance().getCameraWindow().getRotation();
+    auto currentRotation = mEngine.getCameraWindow().getRotation();
     currentRotation.Y = (float)arg1;
     setCameraRotation(currentRotation);
 }
 
 void MainWindow::on_zRot_valueChanged(double arg1)
 {
-    vector3df currentRotation = Engine::getInstance().getCameraWindow().getRotation();
+    vector3df currentRotation = mEngine.getCameraWindow().getRotation();
     currentRotation.Z = (float)arg1;
     setCameraRotation(currentRotation);
 }
@@ -162,11 +163,11 @@ void MainWindow::on_zRot_valueChanged(double arg1)
 
 void MainWindow::moveCamera(const vector3df& virtualVector)
 {
-    CameraWindow& cam = Engine::getInstance().getCameraWindow();
+    CameraWindow& cam = mEngine.getCameraWindow();
     cam.moveVirtual(virtualVector);
     // Camera move changes position and rotation, so we update them in the UI
     updateWidgets();
-    cam.updateScene();
+    scheduleRedraw();
 }
 
 void MainWindow::on_forwardPos_clicked()
@@ -201,10 +202,10 @@ void MainWindow::on_downPos_clicked()
 
 void MainWindow::rotateCamera(const vector3df& vector)
 {
-    CameraWindow& cam = Engine::getInstance().getCameraWindow();
+    CameraWindow& cam = mEngine.getCameraWindow();
     cam.rotate(vector);
     updateWidgets();
-    cam.updateScene();
+    scheduleRedraw();
 }
 
 void MainWindow::on_upRot_clicked()
@@ -368,8 +369,8 @@ void MainWindow::keyPressEvent(QKeyEvent * e)
         }
 
         case Qt::Key_Escape: {
-            Engine::getInstance().stopPlaying();
-            Engine::getInstance().stopLivePlaying();
+            mEngine.stopPlaying();
+            mEngine.stopLivePlaying();
             break;
         }
 
@@ -382,13 +383,14 @@ void MainWindow::keyPressEvent(QKeyEvent * e)
 
 void MainWindow::on_frameIndex_valueChanged(int arg1)
 {
-    Engine::getInstance().setTime(arg1);
+    mEngine.applyTime(arg1);
     updateWidgets();
+    scheduleRedraw();
 }
 
 void MainWindow::on_restartFrame_clicked()
 {
-    mUi->frameIndex->setValue(Engine::getInstance().getSequenceSettings().mInitialTime);
+    mUi->frameIndex->setValue(mEngine.getSequenceSettings().mInitialTime);
 }
 
 void MainWindow::on_past_clicked()
@@ -408,19 +410,23 @@ void MainWindow::on_play_clicked()
     blockAnimationSignals(true);
     changeText(mUi->play, "ESCAPE key to stop");
 
-    Engine& engine = Engine::getInstance();
-
     int from = mUi->fromVideo->value();
     int to = mUi->toVideo->value();
 
-    int beforeTime = engine.getCurrentFrame();
-    engine.play(from, to);
-    engine.setTime(beforeTime);
+    int beforeTime = mEngine.getCurrentFrame();
+    mEngine.play(from, to);
+    mEngine.setTime(beforeTime);
 
     changeText(mUi->play, "Play");
     blockAnimationSignals(false);
 }
 
+void MainWindow::on_playbackRate_valueChanged(double arg1)
+{
+    // Not blocked while playing, so that the rate can be changed on the fly
+    mEngine.setPlaybackRate(arg1);
+}
+
 void MainWindow::changeText(QPushButton* button, const QString& text)
 {
     button->setText(text);
@@ -430,16 +436,33 @@ void MainWindow::changeText(QPushButton* button, const QString& text)
 void MainWindow::on_takeScreenshot_clicked()
 {
     // Take screenshot and name it with current time
-    Engine::getInstance().getCameraWindow().takeScreenshot(QDateTime::currentDateTime().toTime_t());
+    mEngine.getCameraWindow().takeScreenshot(QDateTime::currentDateTime().toTime_t());
 }
 
 void MainWindow::on_useTrajectoryFile_clicked()
 {
-    Engine::getInstance().getCameraWindow().setFollowTrajectoryFile(mUi->useTrajectoryFile->isChecked());
+    mEngine.getCameraWindow().setFollowTrajectoryFile(mUi->useTrajectoryFile->isChecked());
 }
 
 void MainWindow::closeEvent(QCloseEvent *event)
 {
-    Engine::getInstance().stopLivePlaying();
-    Engine::getInstance().stopPlaying();
+    mEngine.stopLivePlaying();
+    mEngine.stopPlaying();
+}
+
+void MainWindow::scheduleRedraw()
+{
+    // Changes made before the event loop gets back to the timer are displayed together
+    if(mIsRedrawScheduled)
+        return;
+
+    mIsRedrawScheduled = true;
+    QTimer::singleShot(0, this, SLOT(redraw()));
+}
+
+void MainWindow::redraw()
+{
+    mIsRedrawScheduled = false;
+    // Frames already displayed while scrubbing are shown again from the cache
+    mEngine.getCameraWindow().redrawCached();
 }
@@ -34,6 +34,8 @@ namespace Ui {
     class MainWindow;
 }
 
+class Engine;
+
 /**
  * @brief Qt window, handling widget events (controller)
  *
@@ -48,9 +50,10 @@ public:
 
     /**
      * Initializes the widgets by using SequenceSettings object from Engine
+     * @param engine engine controlled by the window
      * @param parent parent widget
      */
-    explicit MainWindow(QWidget *parent = 0);
+    explicit MainWindow(Engine& engine, QWidget *parent = 0);
 
     /**
      * Releases memory of Qt GUI
@@ -102,12 +105,18 @@ private slots:
     void on_future_clicked();
     void on_play_clicked();
     void on_restartFrame_clicked();
+    void on_playbackRate_valueChanged(double arg1);
 
     void on_takeScreenshot_clicked();
     void on_useTrajectoryFile_clicked();
 
     void closeEvent(QCloseEvent *event);
 
+    /**
+     * Displays the scene if something changed since the last display
+     */
+    void redraw();
+
 
 
 private:
@@ -143,6 +152,12 @@ private:
      */
     void setCameraRotation(const vector3df& vector);
 
+    /**
+     * Asks for a display of the scene at the next event loop iteration. Several changes in the same iteration,
+     * e.g. repeated spinbox steps, lead to a single display.
+     */
+    void scheduleRedraw();
+
     /**
      * If isBlocked is true, the widget becomes event-blocked and disabled. If isBlocked is false, the widget
      * becomes event-activated and enabled.
@@ -183,7 +198,9 @@ private:
      */
     void modifyWithoutEvent(QSpinBox *spinBox, double val);
 
+    Engine& mEngine;
     Ui::MainWindow* mUi;
+    bool mIsRedrawScheduled;
 };
 
 #endif // MAINWINDOW_H
@@ -16,9 +16,10 @@
  *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <vector>
 #include "engine.h"
 #include "vectorsequence.h"
-#include "science.h"
+#include "kinematics.h"
 #include "moveable.h"
 
 using namespace irr;
@@ -27,7 +28,7 @@ using namespace irr::scene;
 using namespace irr::video;
 
 
-Moveable::Moveable()
+Moveable::Moveable(Engine& engine) : mEngine(engine)
 {
 
 }
@@ -40,14 +41,19 @@ void Moveable::updatePositions(const VectorSequence &positionChunk)
 {
     mPosition.merge(positionChunk);
 
+    auto& sequenceSettings = mEngine.getSequenceSettings();
+    int interval = sequenceSettings.mSpeedInterval;
+    int framerate = sequenceSettings.mFramerate;
+    int nbPoints = sequenceSettings.mNbPointsAverager;
+
     // Store virtual speed for angle
-    storeSpeed(mPosition, positionChunk.getBegin(), mVirtualSpeed);
-    storeSmoothed(mVirtualSpeed, positionChunk.getBegin(), mSmoothedVirtualSpeed);
+    Kinematics::storeSpeed(mPosition, positionChunk.getBegin(), interval, framerate, mVirtualSpeed);
+    Kinematics::storeSmoothed(mVirtualSpeed, positionChunk.getBegin(), nbPoints, mSmoothedVirtualSpeed);
 
     // Store real speed for speed float value
     storeRealPosition(positionChunk.getBegin());
-    storeSpeed(mRealPosition, positionChunk.getBegin(), mRealSpeed);
-    storeSmoothed(mRealSpeed, positionChunk.getBegin(), mSmoothedRealSpeed);
+    Kinematics::storeSpeed(mRealPosition, positionChunk.getBegin(), interval, framerate, mRealSpeed);
+    Kinematics::storeSmoothed(mRealSpeed, positionChunk.getBegin(), nbPoints, mSmoothedRealSpeed);
 
     mRealSpeed.get(0);
 }
@@ -57,6 +63,17 @@ void Moveable::updateRotations(const VectorSequence &rotationChunk)
     mRotation.merge(rotationChunk);
 }
 
+void Moveable::clearTrajectories()
+{
+    mPosition = VectorSequence();
+    mRotation = VectorSequence();
+    mRealPosition = VectorSequence();
+    mVirtualSpeed = VectorSequence();
+    mRealSpeed = VectorSequence();
+    mSmoothedVirtualSpeed = VectorSequence();
+    mSmoothedRealSpeed = VectorSequence();
+}
+
 std::map<int, float> Moveable::getTimeToSpeed(int from) const
 {
     // Compute magnitude of speed vector
@@ -88,55 +105,33 @@ const vector3df Moveable::getRotation(int time) const
     return mRotation.get(time);
 }
 
-void Moveable::storeRealPosition(int from)
+const vector3df Moveable::getInterpolatedPosition(double time) const
 {
-    auto tfm = Engine::getInstance().getAffineTransformation();
-    for (int i = from; i <= mPosition.getEnd(); ++i) {
-        mRealPosition.set(i, tfm.convertToReal(mPosition.get(i)));
-    }
+    if(mEngine.getSequenceSettings().mInterpolation == INTERPOLATION_CATMULL_ROM)
+        return mPosition.getCatmullRom(time);
+
+    return mPosition.getLinear(time);
 }
 
-void Moveable::storeSpeed(const VectorSequence& positions, int from, VectorSequence& speeds)
+const vector3df Moveable::getInterpolatedRotation(double time) const
 {
-    int derivativeInterval = Engine::getInstance().getSequenceSettings().mSpeedInterval;
-
-    // Store uncomputable values
-    int lastNecessaryIndex = derivativeInterval - 1;
-    if(from <= lastNecessaryIndex) {
-        for(int i = 0; i <= lastNecessaryIndex; ++i) {
-            speeds.set(i, vector3df(0, 0, 0));
-        }
-    }
-
-    int framerate = Engine::getInstance().getSequenceSettings().mFramerate;
-    int begin = Science::max(from, derivativeInterval);
-    for(int i = begin; i <= positions.getEnd(); ++i) {
-        speeds.set(i, ((float)framerate) * (positions.get(i) - positions.get(i - derivativeInterval))
-                                / derivativeInterval);
-    }
+    return mRotation.getSlerp(time);
 }
 
-void Moveable::storeSmoothed(const VectorSequence &values, int from, VectorSequence &smoothed)
+void Moveable::storeRealPosition(int from)
 {
-    int nbPointsAverager = Engine::getInstance().getSequenceSettings().mNbPointsAverager;
-
-    // Store uncomputable values
-    int lastNecessaryIndex = nbPointsAverager - 2;
-    if(from <= lastNecessaryIndex) {
-        for(int i = 0; i <= lastNecessaryIndex; ++i) {
-            smoothed.set(i, vector3df(0, 0, 0));
-        }
+    int end = mPosition.getEnd();
+    if(end < from)
+        return;
+
+    // Positions are gathered into an array, to be converted all at once
+    std::vector<vector3df> positions(end - from + 1);
+    for(int i = from; i <= end; ++i) {
+        positions[i - from] = mPosition.get(i);
     }
 
-    int begin = Science::max(from, nbPointsAverager - 1);
-    for(int i = begin; i <= values.getEnd(); ++i) {
-        vector3df sum(0, 0, 0);
-        for(int j = 0; j < nbPointsAverager; ++j) {
-            sum += values.get(i - j);
-        }
-        smoothed.set(i, sum / nbPointsAverager);
+    mEngine.getAffineTransformation().convertToReal(positions.data(), positions.data(), positions.size());
+    for(int i = from; i <= end; ++i) {
+        mRealPosition.set(i, positions[i - from]);
     }
 }
-
-
-
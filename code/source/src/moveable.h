@@ -29,6 +29,7 @@ using namespace irr;
 using namespace irr::core;
 using namespace irr::video;
 
+class Engine;
 
 /**
  * @brief Abstract moveable object on the court with its own trajectory and orientation.
@@ -42,8 +43,9 @@ public:
 
     /**
      * Creates an empty object
+     * @param engine engine providing the coordinate transformation and the sequence settings
      */
-    Moveable();
+    explicit Moveable(Engine& engine);
 
     /**
      * Detroys object
@@ -62,6 +64,11 @@ public:
      */
     virtual void updateRotations(const VectorSequence& rotationChunk);
 
+    /**
+     * Forgets all the trajectory data, before loading another sequence
+     */
+    void clearTrajectories();
+
     /**
      * Returns a map of speeds (in m/s) starting from an index and finishing
      * at the end of the sequence
@@ -92,34 +99,37 @@ public:
      */
     const vector3df getRotation(int time) const;
 
-private:
+    /**
+     * Returns position between two frames, with the interpolation given in the sequence settings
+     * @param time fractional frame index
+     * @return position vector
+     * @see SequenceSettings::mInterpolation
+     */
+    const vector3df getInterpolatedPosition(double time) const;
 
     /**
-     * Stores real position values in mRealPosition
-     * from a start index to the end of the sequence
-     * @param from start index
+     * Returns rotation between two frames, turning the shortest way from the rotation of the previous
+     * frame to the one of the next frame
+     * @param time fractional frame index
+     * @return rotation vector
      */
-    void storeRealPosition(int from);
+    const vector3df getInterpolatedRotation(double time) const;
+
+protected:
 
     /**
-     * Computes the derivative of given position sequence
-     * (from a start index to the end of the sequence)
-     * and stores the result in the given speed sequence
-     * @param positions positions from which to compute speed
-     * @param from start index
-     * @param speeds vector where to store the speed
+     * Engine to which the object belongs
      */
-    void storeSpeed(const VectorSequence& positions, int from, VectorSequence& speeds);
+    Engine& mEngine;
+
+private:
 
     /**
-     * Computes the moving average of the given values
-     * (from a start index to the end of the sequence) and stores
-     * the result in the "smoothed" sequence
-     * @param values values to smooth
+     * Stores real position values in mRealPosition
+     * from a start index to the end of the sequence
      * @param from start index
-     * @param smoothed sequence where to store the smoothed values
      */
-    void storeSmoothed(const VectorSequence& values, int from, VectorSequence& smoothed);
+    void storeRealPosition(int from);
 
     VectorSequence mPosition;
     VectorSequence mRotation;
@@ -16,34 +16,63 @@
  *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cmath>
+
 #include "movingbody.h"
 #include "camerawindow.h"
 #include "engine.h"
+#include "science.h"
+#include "frameprofiler.h"
+#include "tracerecorder.h"
 
-MovingBody::MovingBody(const BodySettings& movingBodySettings) : Moveable()
+MovingBody::MovingBody(Engine& engine, const BodySettings& movingBodySettings) : Moveable(engine)
 {
     this->mMovingBodySettings = movingBodySettings;
+    mAppliedTime = -1;
+    mTrailTime = -1;
 
-    CameraWindow& cam = Engine::getInstance().getCameraWindow();
+    CameraWindow& cam = engine.getCameraWindow();
     auto driver = cam.getDriver();
     auto sceneManager = cam.getSceneManager();
 
     // Create virtualTrajectory color curve
     mColorCurveNode= new ColorCurveNode(movingBodySettings.mTrajColor,
+                                        movingBodySettings.mTrajFade,
+                                        movingBodySettings.mTrajNbPoints + 1,
                                         sceneManager->getRootSceneNode(),
                                         sceneManager);
 
-    Engine& engine = Engine::getInstance();
-
     // Load player model and apply texture if necessary
     auto mesh = sceneManager->getMesh(movingBodySettings.mModelPath);
     if(mesh == nullptr) {
         stringw modelErrorMsg = "Mesh could not be loaded: ";
         modelErrorMsg += movingBodySettings.mModelPath;
-        engine.throwError(modelErrorMsg);
+        Engine::throwError(modelErrorMsg);
     }
 
-    mNode = sceneManager->addAnimatedMeshSceneNode(mesh);
+    // Poses are shared with the other bodies using the same mesh
+    mNode = new PoseSceneNode(mesh, engine.getPoseCache(), sceneManager->getRootSceneNode(), sceneManager);
+
+    // Optional levels of detail for distant bodies
+    IAnimatedMesh* lodMesh = nullptr;
+    if(movingBodySettings.mLodModelPath.size() > 0) {
+        lodMesh = sceneManager->getMesh(movingBodySettings.mLodModelPath);
+        if(lodMesh == nullptr) {
+            stringw lodErrorMsg = "Decimated mesh could not be loaded: ";
+            lodErrorMsg += movingBodySettings.mLodModelPath;
+            Engine::throwError(lodErrorMsg);
+        }
+    }
+    ITexture* billboardTexture = nullptr;
+    if(movingBodySettings.mBillboardPath.size() > 0) {
+        billboardTexture = driver->getTexture(movingBodySettings.mBillboardPath);
+        if(billboardTexture == nullptr) {
+            stringw billboardErrorMsg = "Billboard texture could not be loaded: ";
+            billboardErrorMsg += movingBodySettings.mBillboardPath;
+            Engine::throwError(billboardErrorMsg);
+        }
+    }
+    mNode->setLevelsOfDetail(lodMesh, movingBodySettings.mLodSize, billboardTexture, movingBodySettings.mBillboardSize);
     mNode->setScale(vector3df(movingBodySettings.mScale,
                              movingBodySettings.mScale,
                              movingBodySettings.mScale));
@@ -56,7 +85,7 @@ MovingBody::MovingBody(const BodySettings& movingBodySettings) : Moveable()
         if(mTexture == nullptr) {
             stringw textureErrorMsg = "Texture could not be loaded: ";
             textureErrorMsg += movingBodySettings.mTexturePath;
-            engine.throwError(textureErrorMsg);
+            Engine::throwError(textureErrorMsg);
         }
         mNode->setMaterialTexture(0, mTexture);
     }
@@ -68,11 +97,13 @@ MovingBody::MovingBody(const BodySettings& movingBodySettings) : Moveable()
     mNode->setMaterialFlag(EMF_TRILINEAR_FILTER, true);
     mNode->setMaterialFlag(EMF_ANISOTROPIC_FILTER, true);
     mNode->setMaterialFlag(EMF_ANTI_ALIASING, true);
-    mNode->setLoopMode(false);
-    mNode->setAnimationSpeed(0);
 
     mNode->setVisible(movingBodySettings.mVisible);
 
+    // Bodies hidden behind others in the main camera are skipped
+    if(cam.getSettings().mOcclusionQueries)
+        mNode->enableOcclusionQuery(cam.getCamera());
+
     // Irrlicht 3D text node snippet
 //    // Color the vertices
 //    sceneManager->getMeshManipulator()->setVertexColors(node->getMesh(),
@@ -86,8 +117,21 @@ MovingBody::MovingBody(const BodySettings& movingBodySettings) : Moveable()
 //    textNode->setVisible(false);
 }
 
+MovingBody::~MovingBody()
+{
+    // Model and curve were created with new, so we hold a reference besides the one of their parent
+    mNode->remove();
+    mNode->drop();
+    mColorCurveNode->remove();
+    mColorCurveNode->drop();
+}
+
 void MovingBody::setTime(int time)
-{   
+{
+    TraceRecorder::Span span("setTime");
+    mAppliedTime = time;
+    mEngine.getCameraWindow().invalidateScene();
+
     // Displaying or hiding 3D model
     if(mMovingBodySettings.mVisible) {
         mNode->setVisible(true);
@@ -99,28 +143,61 @@ void MovingBody::setTime(int time)
 
     // Displaying or hiding trajectory color curve
     if(mMovingBodySettings.mTrajVisible) {
-        mColorCurveNode->setLines(lastMoves(time, mMovingBodySettings.mTrajNbPoints));
+        updateTrail(time);
         mColorCurveNode->setVisible(true);
     } else {
         mColorCurveNode->setVisible(false);
     }
 }
 
-std::vector< std::pair<vector3df, vector3df > > MovingBody::lastMoves(int from, int samples)
+void MovingBody::setInterpolatedTime(double time)
 {
-    std::vector< std::pair<vector3df, vector3df > > lines;
-    for(int i = 0; i < samples; ++i) {
-        int index = from - i;
-        if(index >= 1) {
-            // Find both ends of the line
-            vector3df start = getPosition(index - 1);
-            vector3df end = getPosition(index);
-            // Add each position pair to the list
-            std::pair<vector3df, vector3df > singleLine(start, end);
-            lines.push_back(singleLine);
-        }
+    int previous = (int) std::floor(time);
+    if(!isUpToDate(previous))
+        setTime(previous);
+
+    if(mMovingBodySettings.mVisible) {
+        mNode->setPosition(getInterpolatedPosition(time));
+        mNode->setRotation(getInterpolatedRotation(time));
+        mEngine.getCameraWindow().invalidateScene();
     }
 
-    return lines;
+    // The node no longer shows the previous frame, but the color curve still does
+    mAppliedTime = -1;
+}
+
+void MovingBody::updatePositions(const VectorSequence& positionChunk)
+{
+    Moveable::updatePositions(positionChunk);
+    mAppliedTime = -1;
+    mTrailTime = -1;
+}
+
+bool MovingBody::isUpToDate(int time) const
+{
+    return time == mAppliedTime;
+}
+
+void MovingBody::updateTrail(int time)
+{
+    // Curve already ends at this time, for instance after a slow motion image
+    if(time == mTrailTime)
+        return;
+
+    FrameProfiler::ScopedTimer timer(FrameProfiler::STAGE_TRAIL);
+
+    // Sequential playback only adds the newest position to the curve
+    if(mTrailTime >= 0 && time == mTrailTime + 1) {
+        mColorCurveNode->pushPoint(getPosition(time));
+        mTrailTime = time;
+        return;
+    }
+
+    // After a seek, the curve is filled again from its oldest position, a curve of n lines joining n + 1 positions
+    mColorCurveNode->clear();
+    for(int i = Science::max(0, time - mMovingBodySettings.mTrajNbPoints); i <= time; ++i) {
+        mColorCurveNode->pushPoint(getPosition(i));
+    }
+    mTrailTime = time;
 }
 
@@ -21,6 +21,7 @@
 
 #include "moveable.h"
 #include "bodysettings.h"
+#include "posescenenode.h"
 
 /**
  * @brief Concrete moving body with color curve
@@ -34,9 +35,15 @@ public:
 
     /**
      * Initializes the 3D model and its animation
+     * @param engine engine whose window displays the body
      * @param movingBodySettings body settings
      */
-    explicit MovingBody(const BodySettings& movingBodySettings);
+    MovingBody(Engine& engine, const BodySettings& movingBodySettings);
+
+    /**
+     * Removes the 3D model and the color curve from the scene
+     */
+    virtual ~MovingBody();
 
     /**
      * Changes visibility of 3D model according to trajectory data, to handle time indexes missing a position.
@@ -45,12 +52,33 @@ public:
      */
     virtual void setTime(int time) override;
 
+    /**
+     * Shows the body between two frames, for slow motion. The animation and the color curve are the ones of
+     * the previous frame, while the 3D model is moved on the way to the next position.
+     * @param time fractional frame index
+     */
+    void setInterpolatedTime(double time);
+
+    /**
+     * Appends a position chunk, and marks the body as outdated since the positions around the displayed
+     * time may have changed
+     * @param positionChunk chunk of positions to append
+     */
+    virtual void updatePositions(const VectorSequence& positionChunk) override;
+
+    /**
+     * Tells whether the node and the color curve already show the given time, so that setTime() can be skipped
+     * @param time time index
+     * @return true if nothing would change, false else
+     */
+    bool isUpToDate(int time) const;
+
 protected:
 
     /**
-     * 3D model node
+     * 3D model node, showing the first animation frame unless a sub-class changes it
      */
-    IAnimatedMeshSceneNode* mNode;
+    PoseSceneNode* mNode;
 
     /**
      * Texture applied on 3D model
@@ -60,17 +88,20 @@ protected:
 private:
 
     /**
-     * Returns a list of the last positions of the body, grouped by consecutive pair (move lines)
-     * @param from starting index of the list
-     * @param samples number of positions to add to the list
-     * @return list of moves
+     * Makes the color curve end at the position of the given time. The curve is only filled again after a seek.
+     * @param time time index of the newest position
      */
-    std::vector< std::pair<vector3df, vector3df > > lastMoves(int from, int samples);
+    void updateTrail(int time);
 
     BodySettings mMovingBodySettings;
 
     ColorCurveNode* mColorCurveNode;
 
+    // Time shown by the node and the color curve, -1 if they are outdated
+    int mAppliedTime;
+    // Time of the newest position of the color curve, -1 if the curve must be filled again
+    int mTrailTime;
+
     // Irrlicht 3D text node snippet
 //    stringw name;
 //    ITextSceneNode* textNode;
@@ -0,0 +1,62 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NULLVIDEOSINK_H
+#define NULLVIDEOSINK_H
+
+#include "videosink.h"
+
+/**
+ * @brief Video sink discarding the frames
+ *
+ * Used by the benchmark mode, so that the measured throughput is the one of loading, rendering, readback
+ * and conversion, without any encoding or disk access.
+ */
+class NullVideoSink : public VideoSink
+{
+
+public:
+
+    /**
+     * Creates a sink which has received no frame
+     */
+    NullVideoSink();
+
+    /**
+     * Counts the frame and discards it
+     * @param frame converted frame
+     */
+    virtual void writeFrame(const YuvConverter& frame) override;
+
+    /**
+     * Does nothing, there is no output
+     */
+    virtual void finish() override;
+
+    /**
+     * Returns number of discarded frames
+     * @return frame count
+     */
+    int getFrameCount() const;
+
+private:
+
+    int mFrameCount;
+};
+
+#endif // NULLVIDEOSINK_H
@@ -0,0 +1,250 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include "parallelvideosink.h"
+#include "engine.h"
+#include "xvidsegmentencoder.h"
+#include "tracerecorder.h"
+
+ParallelVideoSink::ParallelVideoSink(const std::string& fileName, int width, int height, int framerate,
+                                     int nbThreads, int segmentLength, size_t maxMemory)
+    : mWriter(fileName, width, height, framerate, "XVID")
+{
+    mWidth = width;
+    mHeight = height;
+    mFramerate = framerate;
+
+    // Segments are shortened so that the budget holds the segment being filled and two segments per worker,
+    // but not under a second, since each segment starts with a keyframe. The segment being filled and one
+    // queued segment always fit.
+    int maxFrames = (int) std::min(std::max((size_t) 2, maxMemory / ((size_t) width * height * 3 / 2)),
+                                   (size_t) 1 << 30);
+    int fittingLength = std::max(maxFrames / (2 * nbThreads + 1), std::min(segmentLength, framerate));
+    mSegmentLength = std::max(1, std::min(std::min(segmentLength, fittingLength), maxFrames / 2));
+
+    // Enough segments for every worker to have one in hand and one waiting, if the budget allows it. Workers
+    // without a segment to encode would be useless.
+    mMaxSegmentsInFlight = std::max(1, std::min(2 * nbThreads, maxFrames / mSegmentLength - 1));
+    nbThreads = std::min(nbThreads, mMaxSegmentsInFlight);
+
+    mNextSegmentIndex = 0;
+    mSegmentsInFlight = 0;
+    mNextMuxedIndex = 0;
+    mIsStopping = false;
+
+    mCurrentSegment.reset(new Segment());
+    mCurrentSegment->mIndex = mNextSegmentIndex++;
+
+    for(int i = 0; i < nbThreads; ++i)
+        mWorkers.push_back(std::thread(&ParallelVideoSink::runWorker, this));
+}
+
+ParallelVideoSink::~ParallelVideoSink()
+{
+    stopWorkers();
+}
+
+void ParallelVideoSink::writeFrame(const YuvConverter& frame)
+{
+    reportWorkerError();
+
+    std::vector<unsigned char> buffer;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if(!mFreeFrames.empty()) {
+            buffer.swap(mFreeFrames.back());
+            mFreeFrames.pop_back();
+        }
+    }
+
+    buffer.resize(frame.getDataSize());
+    memcpy(buffer.data(), frame.getData(), frame.getDataSize());
+    mCurrentSegment->mFrames.push_back(std::move(buffer));
+
+    if((int) mCurrentSegment->mFrames.size() >= mSegmentLength)
+        queueCurrentSegment();
+}
+
+void ParallelVideoSink::finish()
+{
+    if(!mCurrentSegment->mFrames.empty())
+        queueCurrentSegment();
+
+    stopWorkers();
+    reportWorkerError();
+    mWriter.close();
+}
+
+void ParallelVideoSink::queueCurrentSegment()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mSegmentMuxed.wait(lock, [this]() { return mSegmentsInFlight < mMaxSegmentsInFlight || mWorkerError; });
+    if(mWorkerError) {
+        lock.unlock();
+        reportWorkerError();
+    }
+
+    mPendingSegments.push_back(std::move(mCurrentSegment));
+    ++mSegmentsInFlight;
+    TraceRecorder::addCounter("segments in flight", mSegmentsInFlight);
+    mSegmentQueued.notify_one();
+    lock.unlock();
+
+    mCurrentSegment.reset(new Segment());
+    mCurrentSegment->mIndex = mNextSegmentIndex++;
+}
+
+void ParallelVideoSink::runWorker()
+{
+    TraceRecorder::setThreadName("encoder");
+    // Errors of the encoder and of the AVI writer are reported by the recording thread
+    Engine::throwErrorsOnThisThread();
+
+    while(true) {
+        std::unique_ptr<Segment> segment;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mSegmentQueued.wait(lock, [this]() { return mIsStopping || !mPendingSegments.empty(); });
+            // Remaining segments are encoded before stopping, unless a worker failed
+            if(mWorkerError || mPendingSegments.empty())
+                return;
+            segment = std::move(mPendingSegments.front());
+            mPendingSegments.pop_front();
+        }
+
+        try {
+            encodeSegment(*segment);
+        } catch(...) {
+            storeWorkerError();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for(auto& buffer : segment->mFrames)
+                mFreeFrames.push_back(std::move(buffer));
+            segment->mFrames.clear();
+            mEncodedSegments[segment->mIndex] = std::move(segment);
+        }
+
+        try {
+            muxEncodedSegments();
+        } catch(...) {
+            storeWorkerError();
+            return;
+        }
+    }
+}
+
+void ParallelVideoSink::encodeSegment(Segment& segment)
+{
+    TraceRecorder::Span span("encode segment");
+    XvidSegmentEncoder encoder(mWidth, mHeight, mFramerate, mSegmentLength);
+
+    segment.mPackets.resize(segment.mFrames.size());
+    segment.mKeyframes.resize(segment.mFrames.size());
+    for(unsigned int i = 0; i < segment.mFrames.size(); ++i) {
+        bool isKeyframe = false;
+        // Frames of the segment are numbered from the beginning of the output
+        TraceRecorder::setFrame(segment.mIndex * mSegmentLength + i);
+        encoder.encode(segment.mFrames[i].data(), segment.mPackets[i], isKeyframe);
+        segment.mKeyframes[i] = isKeyframe;
+    }
+}
+
+void ParallelVideoSink::muxEncodedSegments()
+{
+    // The worker that stored a segment always looks for it afterwards, so none is forgotten
+    std::lock_guard<std::mutex> muxLock(mMuxMutex);
+    TraceRecorder::Span span("mux");
+    while(true) {
+        std::unique_ptr<Segment> segment;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto segmentIt = mEncodedSegments.find(mNextMuxedIndex);
+            if(segmentIt == mEncodedSegments.end())
+                return;
+            segment = std::move(segmentIt->second);
+            mEncodedSegments.erase(segmentIt);
+        }
+
+        for(unsigned int i = 0; i < segment->mPackets.size(); ++i) {
+            mWriter.writeFrame(segment->mPackets[i].data(), segment->mPackets[i].size(), segment->mKeyframes[i]);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            ++mNextMuxedIndex;
+            --mSegmentsInFlight;
+            TraceRecorder::addCounter("segments in flight", mSegmentsInFlight);
+        }
+        mSegmentMuxed.notify_all();
+    }
+}
+
+void ParallelVideoSink::storeWorkerError()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        // Only the first error is reported, the following ones are often consequences of it
+        if(!mWorkerError)
+            mWorkerError = std::current_exception();
+        mIsStopping = true;
+    }
+    mSegmentQueued.notify_all();
+    mSegmentMuxed.notify_all();
+}
+
+void ParallelVideoSink::reportWorkerError()
+{
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        error = mWorkerError;
+    }
+    if(!error)
+        return;
+
+    // Workers are joined before reporting, since throwError() may quit the program
+    stopWorkers();
+    try {
+        std::rethrow_exception(error);
+    } catch(const std::exception& e) {
+        Engine::throwError(stringw(e.what()));
+    } catch(...) {
+        Engine::throwError(L"Video encoding failed");
+    }
+}
+
+void ParallelVideoSink::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mIsStopping = true;
+    }
+    mSegmentQueued.notify_all();
+
+    for(auto& worker : mWorkers) {
+        if(worker.joinable())
+            worker.join();
+    }
+    mWorkers.clear();
+}
@@ -0,0 +1,128 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARALLELVIDEOSINK_H
+#define PARALLELVIDEOSINK_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include "videosink.h"
+#include "aviwriter.h"
+
+/**
+ * @brief Video sink encoding XviD AVI files on several threads
+ *
+ * Recorded frames are gathered in segments of consecutive frames. Each full segment is queued in memory and
+ * encoded as a closed group of pictures by its own XviD instance on a pool of worker threads. Compressed
+ * segments are then muxed in order into a single AVI file. The number of segments waiting to be encoded or
+ * muxed is bounded by a memory budget, which does not grow with the number of threads, so that the rendering
+ * loop waits for the encoders instead of exhausting memory. The budget covers the raw frames of the segment
+ * being filled and of the queued segments. Segments are first shortened, down to one second, then fewer
+ * segments are queued and fewer threads started. Compressed packets waiting to be muxed are not counted.
+ * The first error of a worker stops the workers, and is reported on the recording thread by the next call to
+ * writeFrame() or finish().
+ */
+class ParallelVideoSink : public VideoSink
+{
+
+public:
+
+    /**
+     * Opens the output file and starts the worker threads
+     * @param fileName path to the AVI file to create
+     * @param width frame width
+     * @param height frame height
+     * @param framerate frame rate of the video
+     * @param nbThreads number of encoding threads
+     * @param segmentLength number of frames per segment, reduced if two segments do not fit in the budget
+     * @param maxMemory budget for raw frames in bytes, which holds at least two frames whatever its value
+     */
+    ParallelVideoSink(const std::string& fileName, int width, int height, int framerate,
+                      int nbThreads, int segmentLength, size_t maxMemory);
+
+    /**
+     * Stops the worker threads if finish() was not called
+     */
+    virtual ~ParallelVideoSink();
+
+    /**
+     * Copies a frame into the current segment, and queues the segment for encoding once it is full
+     * @param frame converted frame
+     */
+    virtual void writeFrame(const YuvConverter& frame) override;
+
+    /**
+     * Encodes the last segment, waits for all the segments to be muxed and completes the AVI file
+     */
+    virtual void finish() override;
+
+private:
+
+    struct Segment
+    {
+        int mIndex;
+        std::vector<std::vector<unsigned char>> mFrames;
+        std::vector<std::vector<unsigned char>> mPackets;
+        std::vector<bool> mKeyframes;
+    };
+
+    void queueCurrentSegment();
+    void runWorker();
+    void encodeSegment(Segment& segment);
+    void muxEncodedSegments();
+    void stopWorkers();
+    void storeWorkerError();
+    void reportWorkerError();
+
+    int mWidth;
+    int mHeight;
+    int mFramerate;
+    int mSegmentLength;
+    int mMaxSegmentsInFlight;
+
+    AviWriter mWriter;
+
+    std::unique_ptr<Segment> mCurrentSegment;
+    int mNextSegmentIndex;
+
+    // Shared between the recording thread and the workers, guarded by mMutex
+    std::deque<std::unique_ptr<Segment>> mPendingSegments;
+    std::map<int, std::unique_ptr<Segment>> mEncodedSegments;
+    std::vector<std::vector<unsigned char>> mFreeFrames;
+    int mSegmentsInFlight;
+    int mNextMuxedIndex;
+    bool mIsStopping;
+    std::exception_ptr mWorkerError;
+    std::mutex mMutex;
+    std::condition_variable mSegmentQueued;
+    std::condition_variable mSegmentMuxed;
+
+    // Only one worker writes to the AVI file at a time
+    std::mutex mMuxMutex;
+
+    std::vector<std::thread> mWorkers;
+};
+
+#endif // PARALLELVIDEOSINK_H
@@ -24,97 +24,46 @@
 #include "player.h"
 #include "movingbody.h"
 #include "science.h"
+#include "kinematics.h"
 #include "engine.h"
 
 using namespace irr;
 using namespace irr::core;
 using namespace irr::video;
 
-Player::Player(const BodySettings& playerBodySettings,
+Player::Player(Engine& engine,
+               const BodySettings& playerBodySettings,
                const PlayerSettings& playerSettings)
-    : MovingBody(playerBodySettings)
+    : MovingBody(engine, playerBodySettings)
 {
     this->mPlayerSettings = playerSettings;
 
-    auto driver = Engine::getInstance().getCameraWindow().getDriver();
-    // Create render texture where we can write the jersey text
-    mRenderTexture = driver->addRenderTargetTexture(mPlayerSettings.mTextureSize);
-    mNode->setMaterialTexture(0, mRenderTexture);
-
     mJerseyText = "";
     mJerseyText += playerSettings.mJerseyNumber;
-}
 
-std::map<int, int> Player::computeAnimations(int from) const
-{
-    auto speed = getTimeToSpeed(from);
-
-    // Deduce animation from real speed
-    std::map < int, AnimationAction > frameAction;
-    for(std::map<int, float>::const_iterator s = speed.begin(); s != speed.end(); ++s) {
-        int index = s->first;
-        float magnitude = s->second;
-        if(magnitude < mPlayerSettings.mActions.at(AnimationAction::Walk).mThreshold) {
-            frameAction[index] = AnimationAction::Stand;
-        }
-        else if(magnitude < mPlayerSettings.mActions.at(AnimationAction::Run).mThreshold) {
-            frameAction[index] = AnimationAction::Walk;
-        }
-        else {
-            frameAction[index] = AnimationAction::Run;
+    // Every frame of the actions is skinned now, so that playback only swaps poses
+    for(auto i = mPlayerSettings.mActions.cbegin(); i != mPlayerSettings.mActions.cend(); ++i) {
+        engine.getPoseCache().bake(mNode->getMesh(), playerBodySettings.mModelPath,
+                                   i->second.mBegin, i->second.mEnd, mPlayerSettings.mArePosesSaved);
+        if(mNode->getLodMesh() != nullptr) {
+            engine.getPoseCache().bake(mNode->getLodMesh(), playerBodySettings.mLodModelPath,
+                                       i->second.mBegin, i->second.mEnd, mPlayerSettings.mArePosesSaved);
         }
     }
+}
 
+Player::~Player()
+{
+}
+
+std::map<int, int> Player::computeAnimations(int from) const
+{
     // Compute video framerate and animation framerate to keep fluency
-    float ratioFloat = ((float)Engine::getInstance().getSequenceSettings().mFramerate)
+    float ratioFloat = ((float)mEngine.getSequenceSettings().mFramerate)
                             / ((float)mPlayerSettings.mAnimFramerate);
     int ratio = irr::core::ceil32(ratioFloat);
 
-    // Initialize state and animation counters
-    AnimationAction currentAction = frameAction.begin()->second;
-
-//    // fcounts counts all frames
-//    int fcount = 0;
-//    // fanim takes account of the ratio and skips frames
-//    int fanim = mPlayerSettings.mActions[currentAction].mBegin;
-
-    int fcount = frameAction.begin()->first;
-    int fanim = mTimeToAnimFrame.find(fcount - 1) != mTimeToAnimFrame.end() ?
-                    mTimeToAnimFrame.at(fcount - 1) : mPlayerSettings.mActions.at(currentAction).mBegin;
-
-    // Store the right animation frames
-    std::map<int, int> timeToAnimFrame;
-    for(std::map<int, AnimationAction>::iterator a = frameAction.begin(); a != frameAction.end(); ++a) {
-        int index = a->first;
-        AnimationAction newAction = a->second;
-
-        if(newAction == currentAction) {
-            // If the action remains the same, we switch to next animation frame
-            ++fcount;
-
-            // If the current animation frame has been repeated sufficiently to keep fluency,
-            // we switch to next animation frame
-            if(fcount >= ratio) {
-                fcount = 0;
-                ++fanim;
-            }
-
-            // If we reach the end of the animation we go back to its beginning
-            if(fanim > mPlayerSettings.mActions.at(currentAction).mEnd) {
-                fcount = 0;
-                fanim = mPlayerSettings.mActions.at(currentAction).mBegin;
-            }
-        } else {
-            // If animation state changes, we go to the beginning of new state
-            fcount = 0;
-            fanim = mPlayerSettings.mActions.at(newAction).mBegin;
-        }
-
-        currentAction = newAction;
-        timeToAnimFrame[index] = fanim;
-    }
-
-    return timeToAnimFrame;
+    return Kinematics::computeAnimations(getTimeToSpeed(from), mPlayerSettings.mActions, ratio, mTimeToAnimFrame);
 }
 
 VectorSequence Player::computeRotations(int from) const
@@ -132,16 +81,19 @@ ITexture* Player::getTexture() const
     return mTexture;
 }
 
-ITexture *Player::getRenderTexture() const
+void Player::setJerseyTexture(ITexture* texture, const matrix4& textureMatrix)
 {
-    return mRenderTexture;
+    for(u32 i = 0; i < mNode->getMaterialCount(); ++i) {
+        mNode->getMaterial(i).setTexture(0, texture);
+        mNode->getMaterial(i).setTextureMatrix(0, textureMatrix);
+    }
 }
 
 void Player::setTime(int time)
 {
     MovingBody::setTime(time);
     // Set the right animation
-    mNode->setCurrentFrame(mTimeToAnimFrame[time]);
+    mNode->setFrame(mTimeToAnimFrame[time]);
 }
 
 const PlayerSettings &Player::getPlayerSettings() const
@@ -151,7 +103,7 @@ const PlayerSettings &Player::getPlayerSettings() const
 
 void Player::updatePositions(const VectorSequence& positions)
 {
-    Moveable::updatePositions(positions);
+    MovingBody::updatePositions(positions);
 
     auto rotations = computeRotations(positions.getBegin());
     Moveable::updateRotations(rotations);
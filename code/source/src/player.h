@@ -41,26 +41,34 @@ class Player : public MovingBody
 public:
 
     /**
-     * Creates render texture and extracts animation from trajectories by computing speed
+     * Creates render texture and bakes the animation frames of the actions
+     * @param engine engine whose window displays the player
      * @param movingBodySettings body settings
      * @param playerSettings player settings
      */
-    Player(const BodySettings& movingBodySettings,
+    Player(Engine& engine,
+           const BodySettings& movingBodySettings,
            const PlayerSettings& playerSettings);
 
+    /**
+     * Destroys player
+     */
+    virtual ~Player();
+
     /**
      * Returns the texture of the player without the jersey number
-     * @see CameraWindow::updateScene()
+     * @see JerseyAtlas
      * @return texture player texture
      */
     ITexture* getTexture() const;
 
     /**
-     * Returns texture of the player to write the jersey number on it
-     * @see CameraWindow::updateScene()
-     * @return render texture
+     * Makes the player show its jersey, i.e. its cell of the jersey atlas
+     * @param texture texture containing the jersey
+     * @param textureMatrix transformation from model texture coordinates to the cell of the player
+     * @see JerseyAtlas
      */
-    ITexture* getRenderTexture() const;
+    void setJerseyTexture(ITexture* texture, const matrix4& textureMatrix);
 
     /**
      * Returns text displayed on the player jersey
@@ -86,7 +94,7 @@ public:
      * Appends player trajectory chunk, computes corresponding animations and rotations
      * @param positions positions to append
      */
-    void updatePositions(const VectorSequence& positions);
+    virtual void updatePositions(const VectorSequence& positions) override;
 
 
 private:
@@ -107,7 +115,6 @@ private:
     VectorSequence computeRotations(int from) const;
 
     PlayerSettings mPlayerSettings;
-    ITexture* mRenderTexture;
 
     // Jersey attributes
     stringw mJerseyText;
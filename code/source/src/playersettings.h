@@ -44,6 +44,7 @@ public:
         mAnimFramerate = 0;
         mTeam = 0;
         mJerseyNumber = 0;
+        mArePosesSaved = false;
     }
 
     /**
@@ -76,6 +77,11 @@ public:
      */
     int mJerseyNumber;
 
+    /**
+     * Whether the baked animation frames are saved next to the model for the next runs
+     */
+    bool mArePosesSaved;
+
 };
 
 #endif // PLAYERSETTINGS_H
@@ -0,0 +1,129 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <irrlicht.h>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QString>
+#include "posecache.h"
+
+using namespace irr;
+using namespace irr::scene;
+
+PoseCache::PoseCache(ISceneManager* sceneManager) : mSceneManager(sceneManager)
+{
+
+}
+
+PoseCache::~PoseCache()
+{
+    for(auto i = mPoses.begin(); i != mPoses.end(); ++i) {
+        i->second->drop();
+        i->first.first->drop();
+    }
+}
+
+IMesh* PoseCache::getPose(IAnimatedMesh* mesh, int frame)
+{
+    auto found = mPoses.find(std::make_pair(mesh, frame));
+    if(found != mPoses.end())
+        return found->second;
+
+    IMesh* pose = skinPose(mesh, frame);
+    storePose(mesh, frame, pose);
+    return pose;
+}
+
+void PoseCache::bake(IAnimatedMesh* mesh, const io::path& modelPath, int begin, int end, bool isSaved)
+{
+    for(int frame = begin; frame <= end; ++frame) {
+        if(mPoses.find(std::make_pair(mesh, frame)) != mPoses.end())
+            continue;
+
+        IMesh* pose = isSaved ? loadPose(modelPath, frame) : nullptr;
+        if(pose == nullptr) {
+            pose = skinPose(mesh, frame);
+            if(isSaved)
+                savePose(pose, modelPath, frame);
+        }
+        storePose(mesh, frame, pose);
+    }
+}
+
+unsigned int PoseCache::getPoseCount() const
+{
+    return mPoses.size();
+}
+
+io::path PoseCache::getPosePath(const io::path& modelPath, int frame)
+{
+    io::path posePath = modelPath;
+    posePath += ".pose";
+    posePath += frame;
+    posePath += ".irrmesh";
+    return posePath;
+}
+
+IMesh* PoseCache::loadPose(const io::path& modelPath, int frame)
+{
+    io::path posePath = getPosePath(modelPath, frame);
+
+    // A pose older than the model may come from another version of it
+    QFileInfo poseInfo(QString::fromUtf8(posePath.c_str()));
+    QFileInfo modelInfo(QString::fromUtf8(modelPath.c_str()));
+    if(!poseInfo.exists() || poseInfo.lastModified() < modelInfo.lastModified())
+        return nullptr;
+
+    IAnimatedMesh* loaded = mSceneManager->getMesh(posePath);
+    if(loaded == nullptr)
+        return nullptr;
+
+    // Only the static mesh is kept, the mesh cache of the scene does not need the file
+    IMesh* pose = loaded->getMesh(0);
+    pose->grab();
+    mSceneManager->getMeshCache()->removeMesh(loaded);
+    return pose;
+}
+
+void PoseCache::savePose(IMesh* pose, const io::path& modelPath, int frame)
+{
+    IMeshWriter* writer = mSceneManager->createMeshWriter(EMWT_IRR_MESH);
+    if(writer == nullptr)
+        return;
+
+    io::IWriteFile* file = mSceneManager->getFileSystem()->createAndWriteFile(getPosePath(modelPath, frame));
+    if(file != nullptr) {
+        writer->writeMesh(file, pose);
+        file->drop();
+    }
+    writer->drop();
+}
+
+IMesh* PoseCache::skinPose(IAnimatedMesh* mesh, int frame)
+{
+    // Animating the mesh overwrites its buffers, so they are copied before another frame is asked
+    IMesh* animated = mesh->getMesh(frame, 255, 0, mesh->getFrameCount() - 1);
+    return mSceneManager->getMeshManipulator()->createMeshCopy(animated);
+}
+
+void PoseCache::storePose(IAnimatedMesh* mesh, int frame, IMesh* pose)
+{
+    // Mesh is kept alive as long as it is a key of the cache
+    mesh->grab();
+    mPoses[std::make_pair(mesh, frame)] = pose;
+}
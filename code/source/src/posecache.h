@@ -0,0 +1,131 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POSECACHE_H
+#define POSECACHE_H
+
+#include <map>
+#include <utility>
+#include <irrlicht.h>
+
+using namespace irr;
+using namespace irr::scene;
+
+/**
+ * @brief Static copies of animated meshes, one per animation frame
+ *
+ * Players share the same animated mesh, and Irrlicht skins it again for every node showing it. The cache
+ * skins each frame of a mesh once, keeps a static copy of the result, and gives this copy to all the nodes
+ * showing the same frame. Skinning cost then depends on the number of distinct poses, not on the number of
+ * players.
+ *
+ * The frames of the player actions can be baked when the players are created, so that playback never skins.
+ * Baked frames can also be saved next to the model as Irrlicht meshes, and loaded instead of skinned by the
+ * next runs as long as the model is not modified.
+ */
+class PoseCache
+{
+
+public:
+
+    /**
+     * Creates an empty cache
+     * @param sceneManager scene manager owning the meshes
+     */
+    explicit PoseCache(ISceneManager* sceneManager);
+
+    /**
+     * Releases the poses and the meshes they come from
+     */
+    ~PoseCache();
+
+    /**
+     * Returns the static mesh of an animation frame, and skins it on first request
+     * @param mesh animated mesh
+     * @param frame animation frame
+     * @return static copy of the mesh at this frame, owned by the cache
+     */
+    IMesh* getPose(IAnimatedMesh* mesh, int frame);
+
+    /**
+     * Makes sure that all the frames of a range are in the cache
+     * @param mesh animated mesh
+     * @param modelPath path of the model file of the mesh, next to which poses are saved
+     * @param begin first frame of the range
+     * @param end last frame of the range
+     * @param isSaved true if poses are loaded from and saved to disk, false else
+     */
+    void bake(IAnimatedMesh* mesh, const io::path& modelPath, int begin, int end, bool isSaved);
+
+    /**
+     * Returns number of poses skinned so far
+     * @return number of poses
+     */
+    unsigned int getPoseCount() const;
+
+private:
+
+    PoseCache& operator= (const PoseCache&);
+    PoseCache(const PoseCache&);
+
+    /**
+     * Returns path of the file containing a pose saved on disk
+     * @param modelPath path of the model file
+     * @param frame animation frame
+     * @return path of the pose file
+     */
+    static io::path getPosePath(const io::path& modelPath, int frame);
+
+    /**
+     * Loads a pose saved by a previous run, if it is more recent than the model
+     * @param modelPath path of the model file
+     * @param frame animation frame
+     * @return pose with a reference for the caller, or nullptr if there is no valid saved pose
+     */
+    IMesh* loadPose(const io::path& modelPath, int frame);
+
+    /**
+     * Saves a pose next to the model. Failures are ignored, since the pose can always be skinned again.
+     * @param pose pose to save
+     * @param modelPath path of the model file
+     * @param frame animation frame
+     */
+    void savePose(IMesh* pose, const io::path& modelPath, int frame);
+
+    /**
+     * Skins a frame of the mesh and copies the result
+     * @param mesh animated mesh
+     * @param frame animation frame
+     * @return static copy with a reference for the caller
+     */
+    IMesh* skinPose(IAnimatedMesh* mesh, int frame);
+
+    /**
+     * References a pose in the cache
+     * @param mesh animated mesh
+     * @param frame animation frame
+     * @param pose pose whose reference is given to the cache
+     */
+    void storePose(IAnimatedMesh* mesh, int frame, IMesh* pose);
+
+    ISceneManager* mSceneManager;
+
+    std::map<std::pair<IAnimatedMesh*, int>, IMesh*> mPoses;
+};
+
+#endif // POSECACHE_H
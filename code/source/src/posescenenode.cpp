@@ -0,0 +1,240 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <irrlicht.h>
+#include "posescenenode.h"
+
+using namespace irr;
+using namespace irr::core;
+using namespace irr::scene;
+using namespace irr::video;
+
+const f32 PoseSceneNode::LOD_HYSTERESIS = 1.2f;
+
+PoseSceneNode::PoseSceneNode(IAnimatedMesh* mesh, PoseCache& poseCache, ISceneNode* parent, ISceneManager* mgr,
+                             s32 id)
+    : ISceneNode(parent, mgr, id), mMesh(mesh), mLodMesh(nullptr), mPoseCache(poseCache)
+{
+    mFrame = 0;
+    mPose = mPoseCache.getPose(mMesh, mFrame);
+    mLodPose = nullptr;
+
+    // Copy materials of the mesh, like an animated mesh node does
+    for(u32 i = 0; i < mPose->getMeshBufferCount(); ++i) {
+        mMaterials.push_back(mPose->getMeshBuffer(i)->getMaterial());
+    }
+    mLodFirstMaterial = mMaterials.size();
+
+    mLodSize = 0;
+    mBillboardSize = 0;
+    mOcclusionCamera = nullptr;
+    mLevel = LOD_FULL;
+}
+
+PoseSceneNode::~PoseSceneNode()
+{
+    if(mOcclusionCamera != nullptr)
+        SceneManager->getVideoDriver()->removeOcclusionQuery(this);
+}
+
+void PoseSceneNode::setFrame(int frame)
+{
+    if(frame == mFrame)
+        return;
+
+    mFrame = frame;
+    mPose = mPoseCache.getPose(mMesh, mFrame);
+    if(mLodMesh != nullptr)
+        mLodPose = mPoseCache.getPose(mLodMesh, mFrame);
+}
+
+IAnimatedMesh* PoseSceneNode::getMesh() const
+{
+    return mMesh;
+}
+
+void PoseSceneNode::setLevelsOfDetail(IAnimatedMesh* lodMesh, f32 lodSize, ITexture* billboardTexture,
+                                      f32 billboardSize)
+{
+    mLodMesh = lodMesh;
+    mLodSize = (lodMesh != nullptr) ? lodSize : 0;
+    mBillboardSize = (billboardTexture != nullptr) ? billboardSize : 0;
+
+    // Materials of the decimated mesh follow the ones of the full mesh, so that settings apply to both
+    mMaterials.resize(mLodFirstMaterial);
+    if(mLodMesh != nullptr) {
+        mLodPose = mPoseCache.getPose(mLodMesh, mFrame);
+        for(u32 i = 0; i < mLodPose->getMeshBufferCount(); ++i) {
+            mMaterials.push_back(mLodPose->getMeshBuffer(i)->getMaterial());
+        }
+    }
+
+    if(billboardTexture != nullptr) {
+        mBillboardMaterial.Lighting = false;
+        mBillboardMaterial.BackfaceCulling = false;
+        mBillboardMaterial.MaterialType = EMT_TRANSPARENT_ALPHA_CHANNEL;
+        mBillboardMaterial.setTexture(0, billboardTexture);
+        mBillboardTextureSize = billboardTexture->getOriginalSize();
+    }
+}
+
+IAnimatedMesh* PoseSceneNode::getLodMesh() const
+{
+    return mLodMesh;
+}
+
+void PoseSceneNode::enableOcclusionQuery(ICameraSceneNode* camera)
+{
+    // First pose is close enough to the others for a visibility test
+    SceneManager->getVideoDriver()->addOcclusionQuery(this, mPose);
+    mOcclusionCamera = camera;
+}
+
+void PoseSceneNode::OnRegisterSceneNode()
+{
+    // Body hidden in the previous image of the tested camera is skipped, no result yet is not 0
+    bool isOccluded = mOcclusionCamera != nullptr
+            && SceneManager->getActiveCamera() == mOcclusionCamera
+            && SceneManager->getVideoDriver()->getOcclusionQueryResult(this) == 0;
+
+    if(IsVisible && !isOccluded) {
+        // Level is chosen for the camera about to draw the scene, from its previous level for this camera.
+        // Cameras are only used as keys, a new camera starts from the full mesh.
+        if(mLodSize > 0 || mBillboardSize > 0) {
+            LevelOfDetail& cameraLevel = mCameraLevels[SceneManager->getActiveCamera()];
+            f32 size = getProjectedSize();
+            LevelOfDetail level = getLevelForSize(size);
+            if(level < cameraLevel)
+                level = max_(level, getLevelForSize(size / LOD_HYSTERESIS));
+            cameraLevel = level;
+            mLevel = level;
+        }
+
+        SceneManager->registerNodeForRendering(this);
+    }
+    ISceneNode::OnRegisterSceneNode();
+}
+
+void PoseSceneNode::render()
+{
+    auto driver = SceneManager->getVideoDriver();
+
+    switch(mLevel) {
+        case LOD_FULL: {
+            driver->setTransform(ETS_WORLD, AbsoluteTransformation);
+            drawPose(mPose, 0);
+            break;
+        }
+
+        case LOD_DECIMATED: {
+            driver->setTransform(ETS_WORLD, AbsoluteTransformation);
+            drawPose(mLodPose, mLodFirstMaterial);
+            break;
+        }
+
+        case LOD_BILLBOARD: {
+            drawBillboard();
+            break;
+        }
+    }
+}
+
+PoseSceneNode::LevelOfDetail PoseSceneNode::getLevelForSize(f32 size) const
+{
+    if(size < mBillboardSize)
+        return LOD_BILLBOARD;
+    if(size < mLodSize)
+        return LOD_DECIMATED;
+    return LOD_FULL;
+}
+
+f32 PoseSceneNode::getProjectedSize() const
+{
+    auto camera = SceneManager->getActiveCamera();
+    if(camera == nullptr)
+        return 0;
+
+    // Height of the bounding box, as if it was in front of the camera at the same distance
+    auto box = getTransformedBoundingBox();
+    f32 height = box.getExtent().Y;
+    f32 distance = box.getCenter().getDistanceFrom(camera->getAbsolutePosition());
+    if(distance <= 0)
+        return (f32) SceneManager->getVideoDriver()->getCurrentRenderTargetSize().Height;
+
+    f32 screenHeight = (f32) SceneManager->getVideoDriver()->getCurrentRenderTargetSize().Height;
+    return height / (2 * distance * tanf(camera->getFOV() / 2)) * screenHeight;
+}
+
+void PoseSceneNode::drawPose(IMesh* pose, u32 firstMaterial)
+{
+    auto driver = SceneManager->getVideoDriver();
+    for(u32 i = 0; i < pose->getMeshBufferCount(); ++i) {
+        driver->setMaterial(mMaterials[firstMaterial + i]);
+        driver->drawMeshBuffer(pose->getMeshBuffer(i));
+    }
+}
+
+void PoseSceneNode::drawBillboard()
+{
+    auto driver = SceneManager->getVideoDriver();
+    auto camera = SceneManager->getActiveCamera();
+
+    // Billboard stands on the camera up vector, with the aspect ratio of its texture
+    auto box = getTransformedBoundingBox();
+    f32 height = box.getExtent().Y;
+    f32 width = height * mBillboardTextureSize.Width / max_(1u, mBillboardTextureSize.Height);
+
+    vector3df view = camera->getTarget() - camera->getAbsolutePosition();
+    view.normalize();
+    vector3df right = camera->getUpVector().crossProduct(view);
+    right.normalize();
+    vector3df up = view.crossProduct(right);
+    up.normalize();
+    right *= width / 2;
+    up *= height / 2;
+
+    vector3df center = box.getCenter();
+    SColor white(255, 255, 255, 255);
+    S3DVertex vertices[4] = {
+        S3DVertex(center - right + up, -view, white, vector2df(0, 0)),
+        S3DVertex(center + right + up, -view, white, vector2df(1, 0)),
+        S3DVertex(center + right - up, -view, white, vector2df(1, 1)),
+        S3DVertex(center - right - up, -view, white, vector2df(0, 1))
+    };
+    const u16 indices[6] = { 0, 1, 2, 0, 2, 3 };
+
+    driver->setTransform(ETS_WORLD, IdentityMatrix);
+    driver->setMaterial(mBillboardMaterial);
+    driver->drawVertexPrimitiveList(vertices, 4, indices, 2, EVT_STANDARD, EPT_TRIANGLES, EIT_16BIT);
+}
+
+const aabbox3d<f32>& PoseSceneNode::getBoundingBox() const
+{
+    return mPose->getBoundingBox();
+}
+
+u32 PoseSceneNode::getMaterialCount() const
+{
+    return mMaterials.size();
+}
+
+SMaterial& PoseSceneNode::getMaterial(u32 i)
+{
+    return mMaterials[i];
+}
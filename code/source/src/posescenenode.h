@@ -0,0 +1,187 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POSESCENENODE_H
+#define POSESCENENODE_H
+
+#include <vector>
+#include <map>
+#include <irrlicht.h>
+#include "posecache.h"
+
+using namespace irr;
+using namespace irr::core;
+using namespace irr::scene;
+using namespace irr::video;
+
+/**
+ * @brief Node displaying an animated mesh with poses shared through a PoseCache
+ *
+ * Replaces an animated mesh node whose frame is chosen by hand: the node draws the static pose of its
+ * current frame with its own materials, so that nodes showing the same frame share a single skinning.
+ *
+ * Distant nodes can use a lower level of detail, chosen before each drawing from their height on screen: a
+ * decimated mesh, then a billboard facing the camera. A node only goes back to a finer level once it is
+ * clearly above the threshold, so that it does not flicker between two levels. The level is kept for each
+ * camera, since a multi-view recording draws every image once per camera, with different sizes on screen.
+ *
+ * With an occlusion query, the node is not drawn for a camera while its first pose was entirely hidden
+ * in the previous image of this camera. Results lag by one image, so a body coming out from behind
+ * another one appears one frame late.
+ */
+class PoseSceneNode : public ISceneNode
+{
+public:
+
+    /**
+     * Creates node showing the first frame of the mesh, with the materials of the mesh
+     * @param mesh animated mesh
+     * @param poseCache cache providing the poses, which must outlive the node
+     * @param parent parent node
+     * @param mgr scene manager
+     * @param id node ID
+     */
+    PoseSceneNode(IAnimatedMesh* mesh, PoseCache& poseCache, ISceneNode* parent, ISceneManager* mgr, s32 id = -1);
+
+    /**
+     * Removes occlusion query of the node, if any
+     */
+    virtual ~PoseSceneNode();
+
+    /**
+     * Changes displayed animation frame
+     * @param frame animation frame
+     */
+    void setFrame(int frame);
+
+    /**
+     * Returns animated mesh whose poses are displayed
+     * @return animated mesh
+     */
+    IAnimatedMesh* getMesh() const;
+
+    /**
+     * Enables lower levels of detail. A level with a threshold of 0 is not used.
+     * @param lodMesh decimated animated mesh with the same frames, or nullptr
+     * @param lodSize height on screen in pixels under which the decimated mesh is drawn
+     * @param billboardTexture texture of the billboard, or nullptr
+     * @param billboardSize height on screen in pixels under which the billboard is drawn
+     */
+    void setLevelsOfDetail(IAnimatedMesh* lodMesh, f32 lodSize, ITexture* billboardTexture, f32 billboardSize);
+
+    /**
+     * Returns decimated mesh
+     * @return decimated animated mesh, or nullptr
+     */
+    IAnimatedMesh* getLodMesh() const;
+
+    /**
+     * Registers an occlusion query for the node, whose result is used for one camera only. The queries
+     * must be run by the driver after each drawing of this camera.
+     * @param camera camera whose images are tested
+     */
+    void enableOcclusionQuery(ICameraSceneNode* camera);
+
+    /**
+     * Mandatory method for custom scene node
+     */
+    virtual void OnRegisterSceneNode();
+
+    /**
+     * Mandatory method for custom scene node
+     */
+    virtual void render();
+
+    /**
+     * Mandatory method for custom scene node
+     */
+    virtual const aabbox3d<f32>& getBoundingBox() const;
+
+    /**
+     * Returns materials of the full mesh, then materials of the decimated mesh
+     */
+    virtual u32 getMaterialCount() const;
+
+    /**
+     * Returns materials of the full mesh, then materials of the decimated mesh
+     */
+    virtual SMaterial& getMaterial(u32 i);
+
+private:
+
+    /**
+     * Levels of detail, from the finest to the coarsest
+     */
+    enum LevelOfDetail { LOD_FULL, LOD_DECIMATED, LOD_BILLBOARD };
+
+    /**
+     * A node above a threshold divided by this ratio goes back to the finer level
+     */
+    static const f32 LOD_HYSTERESIS;
+
+    /**
+     * Returns level of detail given by the thresholds for a height on screen
+     * @param size height on screen in pixels
+     * @return level of detail
+     */
+    LevelOfDetail getLevelForSize(f32 size) const;
+
+    /**
+     * Returns height of the node on screen, as seen by the active camera
+     * @return height in pixels
+     */
+    f32 getProjectedSize() const;
+
+    /**
+     * Draws the buffers of a pose
+     * @param pose pose to draw
+     * @param firstMaterial index of the material of the first buffer
+     */
+    void drawPose(IMesh* pose, u32 firstMaterial);
+
+    /**
+     * Draws the billboard, facing the active camera and as high as the full mesh
+     */
+    void drawBillboard();
+
+    IAnimatedMesh* mMesh;
+    IAnimatedMesh* mLodMesh;
+    PoseCache& mPoseCache;
+
+    int mFrame;
+    IMesh* mPose;
+    IMesh* mLodPose;
+
+    // Materials belong to the node, since the poses are shared
+    std::vector<SMaterial> mMaterials;
+    u32 mLodFirstMaterial;
+
+    f32 mLodSize;
+    f32 mBillboardSize;
+    SMaterial mBillboardMaterial;
+    dimension2d<u32> mBillboardTextureSize;
+
+    // Level of the current drawing, and last level chosen for each camera
+    LevelOfDetail mLevel;
+    std::map<ICameraSceneNode*, LevelOfDetail> mCameraLevels;
+
+    ICameraSceneNode* mOcclusionCamera;
+
+};
+
+#endif // POSESCENENODE_H
@@ -0,0 +1,45 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "engine.h"
+#include "rawvideosink.h"
+#include "frameprofiler.h"
+#include "tracerecorder.h"
+
+RawVideoSink::RawVideoSink(const std::string& fileName)
+{
+    mFile.open(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!mFile.is_open()) {
+        Engine::throwError(L"Raw video output file cannot be opened");
+    }
+}
+
+void RawVideoSink::writeFrame(const YuvConverter& frame)
+{
+    FrameProfiler::ScopedTimer timer(FrameProfiler::STAGE_ENCODING);
+    TraceRecorder::Span span("encode");
+    mFile.write((const char*) frame.getData(), frame.getDataSize());
+    if(!mFile.good()) {
+        Engine::throwError(L"Raw video frame could not be written");
+    }
+}
+
+void RawVideoSink::finish()
+{
+    mFile.close();
+}
@@ -0,0 +1,59 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RAWVIDEOSINK_H
+#define RAWVIDEOSINK_H
+
+#include <fstream>
+#include <string>
+#include "videosink.h"
+
+/**
+ * @brief Video sink writing raw I420 frames
+ *
+ * Writes the planes of each frame one after the other without any header, so that the file can be given
+ * to any external encoder (e.g. "ffmpeg -f rawvideo -pix_fmt yuv420p -s WxH -r FPS -i file.yuv").
+ */
+class RawVideoSink : public VideoSink
+{
+
+public:
+
+    /**
+     * Opens the output file
+     * @param fileName path to the raw file to create
+     */
+    explicit RawVideoSink(const std::string& fileName);
+
+    /**
+     * Appends frame planes to the file
+     * @param frame converted frame
+     */
+    virtual void writeFrame(const YuvConverter& frame) override;
+
+    /**
+     * Closes the output file
+     */
+    virtual void finish() override;
+
+private:
+
+    std::ofstream mFile;
+};
+
+#endif // RAWVIDEOSINK_H
@@ -0,0 +1,137 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include "engine.h"
+#include "recordingmanifest.h"
+
+namespace
+{
+    const char* const MANIFEST_HEADER = "avatars-recording 1";
+}
+
+RecordingManifest::RecordingManifest(const std::string& outputName, const std::string& description)
+{
+    mOutputName = outputName;
+    mManifestName = outputName + ".manifest";
+    mDescription = description;
+}
+
+bool RecordingManifest::load()
+{
+    mSegments.clear();
+
+    std::ifstream manifestFile(mManifestName.c_str());
+    if(!manifestFile.is_open())
+        return false;
+
+    std::string line;
+    if(!std::getline(manifestFile, line) || line != MANIFEST_HEADER)
+        return false;
+    if(!std::getline(manifestFile, line) || line != mDescription)
+        return false;
+
+    // Each line is "first last fileName"
+    while(std::getline(manifestFile, line)) {
+        std::istringstream lineStream(line);
+        Segment segment;
+        lineStream >> segment.mFirstFrame >> segment.mLastFrame;
+        std::getline(lineStream >> std::ws, segment.mFileName);
+        if(lineStream.fail() || segment.mFileName.empty())
+            break;
+
+        // Frames must follow each other, and the file must still be there
+        if(!mSegments.empty() && segment.mFirstFrame != mSegments.back().mLastFrame + 1)
+            break;
+        std::ifstream segmentFile(segment.mFileName.c_str());
+        if(!segmentFile.is_open())
+            break;
+
+        mSegments.push_back(segment);
+    }
+
+    return !mSegments.empty();
+}
+
+void RecordingManifest::addSegment(int firstFrame, int lastFrame, const std::string& fileName)
+{
+    Segment segment;
+    segment.mFirstFrame = firstFrame;
+    segment.mLastFrame = lastFrame;
+    segment.mFileName = fileName;
+    mSegments.push_back(segment);
+
+    save();
+}
+
+void RecordingManifest::truncate(int resumeFrame)
+{
+    while(!mSegments.empty() && mSegments.back().mLastFrame >= resumeFrame)
+        mSegments.pop_back();
+}
+
+int RecordingManifest::getResumeFrame(int from) const
+{
+    if(mSegments.empty())
+        return from;
+
+    return mSegments.back().mLastFrame + 1;
+}
+
+std::string RecordingManifest::getNextSegmentFileName() const
+{
+    std::ostringstream fileName;
+    fileName << mOutputName << ".part" << std::setw(4) << std::setfill('0') << mSegments.size();
+    return fileName.str();
+}
+
+const std::vector<RecordingManifest::Segment>& RecordingManifest::getSegments() const
+{
+    return mSegments;
+}
+
+void RecordingManifest::remove()
+{
+    for(auto& segment : mSegments)
+        std::remove(segment.mFileName.c_str());
+    mSegments.clear();
+
+    std::remove(mManifestName.c_str());
+}
+
+void RecordingManifest::save() const
+{
+    // Write a temporary file and rename it, rename being atomic on POSIX file systems
+    std::string temporaryName = mManifestName + ".tmp";
+    {
+        std::ofstream manifestFile(temporaryName.c_str(), std::ios::out | std::ios::trunc);
+        manifestFile << MANIFEST_HEADER << std::endl;
+        manifestFile << mDescription << std::endl;
+        for(auto& segment : mSegments)
+            manifestFile << segment.mFirstFrame << " " << segment.mLastFrame << " " << segment.mFileName << std::endl;
+
+        if(!manifestFile.good())
+            Engine::throwError(L"Recording manifest could not be written");
+    }
+
+    if(std::rename(temporaryName.c_str(), mManifestName.c_str()) != 0)
+        Engine::throwError(L"Recording manifest could not be replaced");
+}
@@ -0,0 +1,113 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RECORDINGMANIFEST_H
+#define RECORDINGMANIFEST_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief On-disk record of the finished segments of a checkpointed recording
+ *
+ * The manifest is a small text file written next to the video output. Its first line identifies the
+ * recording (range, segment length, frame size, frame rate and format), and each following line describes
+ * a segment file whose encoding has been completed. The state of the scene only depends on the frame index
+ * (see Engine::setTime()), so the first frame after the last finished segment is all that is needed to
+ * resume a recording.
+ *
+ * The file is replaced atomically after each segment, so that a crash never leaves a corrupted manifest.
+ */
+class RecordingManifest
+{
+
+public:
+
+    /**
+     * @brief Finished segment of the recording
+     */
+    struct Segment
+    {
+        int mFirstFrame;
+        int mLastFrame;
+        std::string mFileName;
+    };
+
+    /**
+     * Creates an empty manifest for a recording
+     * @param outputName name of the final video file
+     * @param description identification of the recording settings, without line breaks
+     */
+    RecordingManifest(const std::string& outputName, const std::string& description);
+
+    /**
+     * Loads the finished segments from the manifest file, if it exists and describes the same recording.
+     * Segments are also ignored from the first one whose file is missing.
+     * @return true if segments of a previous run can be reused
+     */
+    bool load();
+
+    /**
+     * Appends a finished segment and saves the manifest
+     * @param firstFrame first frame of the segment
+     * @param lastFrame last frame of the segment
+     * @param fileName file containing the encoded segment
+     */
+    void addSegment(int firstFrame, int lastFrame, const std::string& fileName);
+
+    /**
+     * Forgets the segments ending at or after a frame, when other outputs of the same recording are late
+     * @param resumeFrame frame from which the recording continues
+     */
+    void truncate(int resumeFrame);
+
+    /**
+     * Returns the frame from which the recording must continue
+     * @param from first frame of the whole recording
+     * @return frame following the last finished segment
+     */
+    int getResumeFrame(int from) const;
+
+    /**
+     * Returns the name of the file for a new segment
+     * @return segment file name
+     */
+    std::string getNextSegmentFileName() const;
+
+    /**
+     * Returns finished segments, in the order of the recording
+     * @return segments
+     */
+    const std::vector<Segment>& getSegments() const;
+
+    /**
+     * Deletes the segment files and the manifest once the final video has been assembled
+     */
+    void remove();
+
+private:
+
+    void save() const;
+
+    std::string mOutputName;
+    std::string mManifestName;
+    std::string mDescription;
+    std::vector<Segment> mSegments;
+};
+
+#endif // RECORDINGMANIFEST_H
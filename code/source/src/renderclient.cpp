@@ -0,0 +1,102 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <QDir>
+#include <QString>
+#include <QStringList>
+#include <QLocalSocket>
+#include "renderdaemon.h"
+#include "renderclient.h"
+
+int RenderClient::submit(const std::vector<std::string>& args)
+{
+    std::string serverName = RenderDaemon::DEFAULT_SERVER_NAME;
+    std::vector<std::string> jobArgs;
+    for(unsigned int i = 0; i < args.size(); ++i) {
+        if(args.at(i) == "--server" && i + 1 < args.size()) {
+            serverName = args.at(++i);
+        } else {
+            jobArgs.push_back(args.at(i));
+        }
+    }
+
+    // Frames and output are optional, -1 and empty meaning the values of the configuration
+    QString from = "-1";
+    QString to = "-1";
+    QString output = "";
+    if(jobArgs.size() == 2 || jobArgs.size() == 4) {
+        output = QString::fromStdString(jobArgs.back());
+    }
+    if(jobArgs.size() == 3 || jobArgs.size() == 4) {
+        from = QString::fromStdString(jobArgs.at(1));
+        to = QString::fromStdString(jobArgs.at(2));
+    }
+    if(jobArgs.empty() || jobArgs.size() > 4) {
+        printUsage();
+        return 1;
+    }
+
+    QLocalSocket socket;
+    socket.connectToServer(QString::fromStdString(serverName));
+    if(!socket.waitForConnected(3000)) {
+        std::cerr << "Error: render daemon " << serverName << " is not running" << std::endl;
+        return 1;
+    }
+
+    // The daemon resolves relative paths from our working directory
+    QStringList fields;
+    fields << "JOB" << QDir::currentPath() << QString::fromStdString(jobArgs.at(0)) << from << to << output;
+    socket.write((fields.join("\t") + "\n").toUtf8());
+    socket.flush();
+
+    while(socket.waitForReadyRead(-1)) {
+        while(socket.canReadLine()) {
+            QStringList reply = QString::fromUtf8(socket.readLine()).trimmed().split(" ");
+            if(reply.size() < 2)
+                continue;
+
+            const QString& type = reply.at(0);
+            std::string id = reply.at(1).toStdString();
+            if(type == "QUEUED" && reply.size() >= 3) {
+                std::cout << "Job " << id << " queued at position " << reply.at(2).toStdString() << std::endl;
+            } else if(type == "STARTED") {
+                std::cout << "Job " << id << " started" << std::endl;
+            } else if(type == "PROGRESS" && reply.size() >= 3) {
+                std::cout << "\rJob " << id << ": " << reply.at(2).toStdString() << "%" << std::flush;
+            } else if(type == "DONE" && reply.size() >= 3) {
+                std::cout << std::endl << "Job " << id << " done in "
+                          << reply.at(2).toInt() / 1000.0 << " s" << std::endl;
+                return 0;
+            } else if(type == "FAILED") {
+                // The message is made of the remaining words
+                std::cerr << std::endl << "Error: job " << id << " failed: "
+                          << reply.join(" ").section(" ", 2).toStdString() << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    std::cerr << std::endl << "Error: connection to render daemon lost" << std::endl;
+    return 1;
+}
+
+void RenderClient::printUsage()
+{
+    std::cout << "Usage: Avatars --submit [--server name] config.xml [from to] [output.avi]" << std::endl;
+}
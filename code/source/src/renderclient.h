@@ -0,0 +1,48 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RENDERCLIENT_H
+#define RENDERCLIENT_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Command line client of the render daemon
+ *
+ * Submits a job to a running RenderDaemon and prints its progress until it is done.
+ * @see RenderDaemon
+ */
+class RenderClient
+{
+
+public:
+
+    /**
+     * Submits a job and waits for its end. Arguments are [--server name] config.xml [from to] [output.avi]
+     * @param args arguments following --submit
+     * @return status code: 0 if the job is done, 1 otherwise
+     */
+    static int submit(const std::vector<std::string>& args);
+
+private:
+
+    static void printUsage();
+};
+
+#endif // RENDERCLIENT_H
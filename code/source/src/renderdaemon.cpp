@@ -0,0 +1,146 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <stdexcept>
+#include <QCoreApplication>
+#include <QTimer>
+#include <QTime>
+#include <QDir>
+#include <QStringList>
+#include "engine.h"
+#include "renderdaemon.h"
+
+const char* const RenderDaemon::DEFAULT_SERVER_NAME = "avatars-render";
+
+RenderDaemon::RenderDaemon(Engine& engine, const std::string& serverName) : mEngine(engine)
+{
+    mNextJobId = 1;
+    mIsProcessing = false;
+
+    // Remove the socket left by a daemon which did not quit properly
+    QString name = QString::fromStdString(serverName);
+    QLocalServer::removeServer(name);
+    if(!mServer.listen(name)) {
+        Engine::throwError(L"Render daemon could not listen on its local socket");
+    }
+    connect(&mServer, SIGNAL(newConnection()), this, SLOT(acceptConnection()));
+
+    std::cout << "Render daemon listening on " << serverName << std::endl;
+}
+
+void RenderDaemon::acceptConnection()
+{
+    while(mServer.hasPendingConnections()) {
+        QLocalSocket* client = mServer.nextPendingConnection();
+        connect(client, SIGNAL(readyRead()), this, SLOT(readRequests()));
+        connect(client, SIGNAL(disconnected()), client, SLOT(deleteLater()));
+    }
+}
+
+void RenderDaemon::readRequests()
+{
+    QLocalSocket* client = qobject_cast<QLocalSocket*>(sender());
+    if(client == nullptr)
+        return;
+
+    while(client->canReadLine()) {
+        QStringList fields = QString::fromUtf8(client->readLine()).trimmed().split("\t");
+        bool isFromValid = false;
+        bool isToValid = false;
+        if(fields.size() != 6 || fields.at(0) != "JOB") {
+            send(client, "FAILED 0 malformed request");
+            continue;
+        }
+
+        RenderJob job;
+        job.mId = mNextJobId++;
+        job.mClient = client;
+        job.mWorkingDirectory = fields.at(1);
+        job.mConfigPath = fields.at(2).toStdString();
+        job.mFrom = fields.at(3).toInt(&isFromValid);
+        job.mTo = fields.at(4).toInt(&isToValid);
+        job.mOutputName = fields.at(5).toStdString();
+        if(!isFromValid || !isToValid) {
+            send(client, QString("FAILED %1 invalid frame range").arg(job.mId));
+            continue;
+        }
+
+        mJobs.push_back(job);
+        send(client, QString("QUEUED %1 %2").arg(job.mId).arg((int) mJobs.size()));
+    }
+
+    // Jobs are run from the event loop, not from the middle of a socket notification
+    QTimer::singleShot(0, this, SLOT(processQueue()));
+}
+
+void RenderDaemon::processQueue()
+{
+    // Events are processed during a job, which may call this slot again
+    if(mIsProcessing)
+        return;
+
+    mIsProcessing = true;
+    while(!mJobs.empty()) {
+        RenderJob job = mJobs.front();
+        mJobs.pop_front();
+        runJob(job);
+    }
+    mIsProcessing = false;
+}
+
+void RenderDaemon::send(QLocalSocket* client, const QString& line)
+{
+    if(client == nullptr || client->state() != QLocalSocket::ConnectedState)
+        return;
+
+    client->write((line + "\n").toUtf8());
+    client->flush();
+}
+
+void RenderDaemon::runJob(const RenderJob& job)
+{
+    send(job.mClient, QString("STARTED %1").arg(job.mId));
+    std::cout << "Job " << job.mId << ": " << job.mConfigPath << std::endl;
+
+    QTime timer;
+    timer.start();
+    int lastPercent = -1;
+    auto progress = [&](int frame) {
+        int from = job.mFrom >= 0 ? job.mFrom : mEngine.getSequenceSettings().mStartTime;
+        int to = job.mTo >= 0 ? job.mTo : mEngine.getSequenceSettings().mEndTime;
+        int percent = to > from ? (100 * (frame - from)) / (to - from) : 100;
+        if(percent != lastPercent) {
+            lastPercent = percent;
+            send(job.mClient, QString("PROGRESS %1 %2").arg(job.mId).arg(percent));
+        }
+
+        // Keep accepting jobs and sending progress while recording
+        QCoreApplication::processEvents();
+    };
+
+    try {
+        if(!QDir::setCurrent(job.mWorkingDirectory))
+            throw std::runtime_error("working directory does not exist");
+        mEngine.renderJob(job.mConfigPath, job.mFrom, job.mTo, job.mOutputName, progress);
+        send(job.mClient, QString("DONE %1 %2").arg(job.mId).arg(timer.elapsed()));
+    } catch(const std::exception& e) {
+        std::cout << "Job " << job.mId << " failed: " << e.what() << std::endl;
+        send(job.mClient, QString("FAILED %1 %2").arg(job.mId).arg(QString::fromStdString(e.what())));
+    }
+}
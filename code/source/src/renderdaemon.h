@@ -0,0 +1,114 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RENDERDAEMON_H
+#define RENDERDAEMON_H
+
+#include <string>
+#include <deque>
+#include <QObject>
+#include <QString>
+#include <QPointer>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+class Engine;
+
+/**
+ * @brief Resident render server
+ *
+ * Listens on a local socket for render jobs and records them one after the other with the engine, which stays
+ * loaded between jobs. A job submitted with the configuration of the previous job therefore starts without
+ * creating the device, loading the scene or drawing the jerseys again.
+ *
+ * The protocol is made of text lines. A client sends one line per job, with tab separated fields:
+ * JOB, working directory, configuration file, first frame, last frame and output file (frames are -1 and the
+ * output is empty to use the values of the configuration). The daemon answers with the following lines:
+ * "QUEUED id position", "STARTED id", "PROGRESS id percent", and finally "DONE id milliseconds" or
+ * "FAILED id message".
+ * @see RenderClient
+ */
+class RenderDaemon : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Name of the local socket used when none is given
+     */
+    static const char* const DEFAULT_SERVER_NAME;
+
+    /**
+     * Starts listening for clients
+     * @param engine engine recording the jobs
+     * @param serverName name of the local socket
+     */
+    RenderDaemon(Engine& engine, const std::string& serverName);
+
+private slots:
+
+    /**
+     * Accepts pending client connections
+     */
+    void acceptConnection();
+
+    /**
+     * Reads job lines sent by a client, and queues the jobs
+     */
+    void readRequests();
+
+    /**
+     * Runs the queued jobs until the queue is empty
+     */
+    void processQueue();
+
+private:
+
+    struct RenderJob
+    {
+        int mId;
+        QPointer<QLocalSocket> mClient;
+        QString mWorkingDirectory;
+        std::string mConfigPath;
+        int mFrom;
+        int mTo;
+        std::string mOutputName;
+    };
+
+    /**
+     * Sends a line to a client, if it is still connected
+     * @param client client socket
+     * @param line line without line break
+     */
+    void send(QLocalSocket* client, const QString& line);
+
+    /**
+     * Records a job and reports its progress to its client
+     * @param job job to run
+     */
+    void runJob(const RenderJob& job);
+
+    Engine& mEngine;
+    QLocalServer mServer;
+    std::deque<RenderJob> mJobs;
+    int mNextJobId;
+    bool mIsProcessing;
+};
+
+#endif // RENDERDAEMON_H
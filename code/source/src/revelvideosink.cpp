@@ -0,0 +1,135 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <revel.h>
+#include "revelvideosink.h"
+#include "engine.h"
+#include "frameprofiler.h"
+#include "tracerecorder.h"
+
+namespace
+{
+    /**
+     * Reports a Revel error with its code, through Engine::throwError() so that the daemon only fails the job
+     */
+    void throwRevelError(const std::string& message, Revel_Error revError)
+    {
+        std::string text = message + " (Revel error " + std::to_string((int) revError) + ")";
+        Engine::throwError(stringw(text.c_str()));
+    }
+}
+
+//------------------------------------------------------------------------------------------------------
+// The following is a code snippet from Revel examples, split into encoder creation, frame encoding and
+// finalization
+//------------------------------------------------------------------------------------------------------
+
+RevelVideoSink::RevelVideoSink(const std::string& fileName, int width, int height, int framerate)
+{
+    mFrameCount = 0;
+
+    // Make sure the API version of Revel we're compiling against matches the
+    // header files!  This is terribly important!
+    if (REVEL_API_VERSION != Revel_GetApiVersion()) {
+        std::string text = "Revel version mismatch: headers have API version " + std::to_string(REVEL_API_VERSION)
+                + ", library has API version " + std::to_string(Revel_GetApiVersion());
+        Engine::throwError(stringw(text.c_str()));
+    }
+
+    // Create an encoder
+    Revel_Error revError = Revel_CreateEncoder(&mEncoderHandle);
+    if (revError != REVEL_ERR_NONE) {
+        throwRevelError("Revel encoder could not be created", revError);
+    }
+
+    // Set up the encoding parameters.  ALWAYS call Revel_InitializeParams()
+    // before filling in your application's parameters, to ensure that all
+    // fields especially ones that you may not know about) are initialized
+    // to safe values.
+    Revel_Params revParams;
+    Revel_InitializeParams(&revParams);
+    revParams.width = width;
+    revParams.height = height;
+    revParams.frameRate = framerate;
+    revParams.quality = 1.0f;
+    revParams.codec = REVEL_CD_XVID;
+
+    revParams.hasAudio = false;
+    revParams.audioChannels = 2;
+    revParams.audioRate = 22050;
+    revParams.audioBits = 16;
+    revParams.audioSampleFormat = REVEL_ASF_PCM;
+
+    // Initialize encoding
+    revError = Revel_EncodeStart(mEncoderHandle, fileName.c_str(), &revParams);
+    if (revError != REVEL_ERR_NONE) {
+        // Destructor does not run when the constructor throws
+        Revel_DestroyEncoder(mEncoderHandle);
+        throwRevelError("Revel could not start encoding " + fileName, revError);
+    }
+}
+
+RevelVideoSink::~RevelVideoSink()
+{
+    Revel_DestroyEncoder(mEncoderHandle);
+}
+
+void RevelVideoSink::writeFrame(const YuvConverter& frame)
+{
+    // Planar frames are given to XviD as they are, which spares its own colorspace conversion
+    Revel_VideoFrame revFrame;
+    revFrame.width = frame.getWidth();
+    revFrame.height = frame.getHeight();
+    revFrame.bytesPerPixel = 1;
+    revFrame.pixelFormat = REVEL_PF_I420;
+    revFrame.pixels = const_cast<unsigned char*>(frame.getData());
+
+    int frameSize;
+    FrameProfiler::ScopedTimer timer(FrameProfiler::STAGE_ENCODING);
+    TraceRecorder::Span span("encode");
+    Revel_Error revError = Revel_EncodeFrame(mEncoderHandle, &revFrame, &frameSize);
+    if (revError != REVEL_ERR_NONE) {
+        throwRevelError("Revel could not write a frame", revError);
+    }
+
+    ++mFrameCount;
+}
+
+void RevelVideoSink::finish()
+{
+    // Choose audio settings
+    int totalAudioBytes = 0;
+    int audioBufferSize = mFrameCount;
+    char* audioBuffer = new char[audioBufferSize];
+    for(int i = 0; i < audioBufferSize; ++i)
+        audioBuffer[i] = 0;
+    Revel_Error revError = Revel_EncodeAudio(mEncoderHandle, audioBuffer, audioBufferSize, &totalAudioBytes);
+    delete [] audioBuffer;
+    if (revError != REVEL_ERR_NONE) {
+        throwRevelError("Revel could not write the audio", revError);
+    }
+
+    // Finalize encoding. If this step is skipped, the output movie will
+    // be unviewable!
+    int totalSize;
+    revError = Revel_EncodeEnd(mEncoderHandle, &totalSize);
+    if (revError != REVEL_ERR_NONE){
+        throwRevelError("Revel could not end encoding", revError);
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REVELVIDEOSINK_H
+#define REVELVIDEOSINK_H
+
+#include <string>
+#include "videosink.h"
+
+/**
+ * @brief Video sink encoding XviD AVI files with the Revel library
+ *
+ * Sends I420 frames to a single Revel encoder.
+ */
+class RevelVideoSink : public VideoSink
+{
+
+public:
+
+    /**
+     * Creates the Revel encoder and starts encoding
+     * @param fileName path to the AVI file to create
+     * @param width frame width
+     * @param height frame height
+     * @param framerate frame rate of the video
+     */
+    RevelVideoSink(const std::string& fileName, int width, int height, int framerate);
+
+    /**
+     * Destroys the Revel encoder
+     */
+    virtual ~RevelVideoSink();
+
+    /**
+     * Encodes a frame
+     * @param frame converted frame
+     */
+    virtual void writeFrame(const YuvConverter& frame) override;
+
+    /**
+     * Writes the audio track and ends encoding. If this step is skipped, the output movie will be unviewable
+     */
+    virtual void finish() override;
+
+private:
+
+    int mEncoderHandle;
+    int mFrameCount;
+};
+
+#endif // REVELVIDEOSINK_H
@@ -20,7 +20,11 @@
 #define SEQUENCESETTINGS_H
 
 
-enum RUN_MODE { MODE_GUI = 0, MODE_CONSOLE = 1, MODE_LIVE = 2 };
+enum RUN_MODE { MODE_GUI = 0, MODE_CONSOLE = 1, MODE_LIVE = 2, MODE_BENCHMARK = 3 };
+
+enum VIDEO_FORMAT { FORMAT_XVID = 0, FORMAT_I420 = 1 };
+
+enum INTERPOLATION { INTERPOLATION_LINEAR = 0, INTERPOLATION_CATMULL_ROM = 1 };
 
 /**
  * @brief Sequence settings
@@ -38,12 +42,20 @@ public:
         mMode = MODE_GUI;
         mFrameNumber = 0;
         mFramerate = 0;
+        mOutputFramerate = 0;
+        mInterpolation = INTERPOLATION_LINEAR;
         mStartTime = 0;
         mEndTime = 0;
         mInitialTime = 0;
         mVideoOutputName = "";
+        mVideoFormat = FORMAT_XVID;
+        mVideoThreads = 1;
+        mVideoSegmentLength = 0;
+        mVideoMemory = 1024;
+        mVideoCheckpointLength = 0;
         mSpeedInterval = 0;
         mNbPointsAverager = 0;
+        mTracePath = "";
     }
 
     /**
@@ -61,6 +73,17 @@ public:
      */
     int mFramerate;
 
+    /**
+     * Frame rate of the recorded videos and of the playback. Images between two frames of the sequence
+     * show interpolated positions.
+     */
+    int mOutputFramerate;
+
+    /**
+     * Interpolation of the positions between two frames of the sequence
+     */
+    INTERPOLATION mInterpolation;
+
     /**
      * Start of the sub-part of the sequence to record
      */
@@ -81,6 +104,31 @@ public:
      */
     std::string mVideoOutputName;
 
+    /**
+     * Format of output file: XviD AVI, or raw I420 frames for external encoders
+     */
+    VIDEO_FORMAT mVideoFormat;
+
+    /**
+     * Number of threads encoding XviD output, 0 for one per processor core
+     */
+    int mVideoThreads;
+
+    /**
+     * Number of frames per independently encoded segment when several threads are used, 0 for two seconds
+     */
+    int mVideoSegmentLength;
+
+    /**
+     * Memory in megabytes for the frames waiting to be encoded when several threads are used
+     */
+    int mVideoMemory;
+
+    /**
+     * Number of frames between two checkpoints of a resumable recording, 0 to record without checkpoints
+     */
+    int mVideoCheckpointLength;
+
     /**
      * Interval for speed computation (derivative)
      */
@@ -91,6 +139,11 @@ public:
      */
     int mNbPointsAverager;
 
+    /**
+     * Chrome trace file recording the activity of the engine, or an empty string to disable tracing
+     */
+    std::string mTracePath;
+
 };
 
 #endif // SEQUENCESETTINGS_H
@@ -20,6 +20,7 @@
 #include <fstream>
 #include <sstream>
 #include <set>
+#include <cstring>
 #include "libs/tinyxml2.h"
 #include "science.h"
 #include "engine.h"
@@ -27,59 +28,35 @@
 
 SettingsParser::SettingsParser(std::string configurationFilePath)
 {
-    Engine& e = Engine::getInstance();
-
     // Initialize XMLDocument and create shortcuts to XMLElements for later use
     if(mDoc.LoadFile(configurationFilePath.c_str()) != XML_NO_ERROR)
-        e.throwError(L"Config file cannot be loaded");
+        Engine::throwError(L"Config file cannot be loaded");
 
     auto avatarsConfig = mDoc.FirstChildElement("avatarsConfig");
     if(avatarsConfig == nullptr)
-        e.throwError(L"parsing avatarsConfig tag");
+        Engine::throwError(L"parsing avatarsConfig tag");
 
     mGraphicsTag = avatarsConfig->FirstChildElement("graphics");
     if(mGraphicsTag == nullptr)
-        e.throwError(L"parsing graphics tag");
+        Engine::throwError(L"parsing graphics tag");
     exploreGraphicsTag();
 
     mInputTag = avatarsConfig->FirstChildElement("input");
     if(mInputTag == nullptr)
-        e.throwError(L"parsing input tag");
+        Engine::throwError(L"parsing input tag");
     exploreInputTag();
 
     mOutputTag = avatarsConfig->FirstChildElement("output");
     if(mOutputTag == nullptr)
-        e.throwError(L"parsing output tag");
+        Engine::throwError(L"parsing output tag");
     exploreOutputTag();
 
     mAvatarsTag = avatarsConfig->FirstChildElement("avatars");
     if(mAvatarsTag == nullptr)
-        e.throwError(L"parsing avatars tag");
+        Engine::throwError(L"parsing avatars tag");
     exploreAvatarsTag();
 }
 
-std::tuple<int, int, vector2df> SettingsParser::getPlayerTokens(const std::string &line)
-{
-    auto strTokens = Science::split(line);
-    return std::make_tuple(std::stoi(strTokens.at(0)), std::stoi(strTokens.at(1)),
-                           vector2df(std::stof(strTokens.at(2)), std::stof(strTokens.at(3))));
-}
-
-std::tuple<int, vector3df> SettingsParser::getBallTokens(const std::string &line)
-{
-    auto strTokens = Science::split(line);
-    return std::make_tuple(std::stoi(strTokens.at(0)),
-                           vector3df(std::stof(strTokens.at(1)), std::stof(strTokens.at(2)), std::stof(strTokens.at(3))));
-}
-
-std::tuple<int, vector3df, vector3df> SettingsParser::getCameraTokens(const std::string &line)
-{
-    auto strTokens = Science::split(line);
-    return std::make_tuple(std::stoi(strTokens.at(0)),
-                           vector3df(std::stof(strTokens.at(1)), std::stof(strTokens.at(2)), std::stof(strTokens.at(3))),
-                           vector3df(std::stof(strTokens.at(4)), std::stof(strTokens.at(5)), std::stof(strTokens.at(6))));
-}
-
 std::tuple<int, int, int> SettingsParser::getTeamCorrespondance(const std::string &line)
 {
     auto strTokens = Science::split(line);
@@ -89,20 +66,17 @@ std::tuple<int, int, int> SettingsParser::getTeamCorrespondance(const std::strin
 
 CourtSettings SettingsParser::retrieveCourtSettings()
 {
-    Engine& e = Engine::getInstance();
-
     CourtSettings courtSettings;
     courtSettings.mScenePath = mSceneTag->Attribute("irrscene");
     if(courtSettings.mScenePath == nullptr
         || mSceneTag->QueryFloatAttribute("scale", &courtSettings.mScale) != XML_NO_ERROR)
-        e.throwError(L"parsing scene path or scale");
+        Engine::throwError(L"parsing scene path or scale");
 
     return courtSettings;
 }
 
 CameraSettings SettingsParser::retrieveCameraSettings()
 {
-    Engine& e = Engine::getInstance();
     CameraSettings camSettings;
 
     // Camera follows trajectory file by default
@@ -117,10 +91,23 @@ CameraSettings SettingsParser::retrieveCameraSettings()
             || mWindowTag->QueryIntAttribute("bgColorR", &bgColorR) != XML_NO_ERROR
             || mWindowTag->QueryIntAttribute("bgColorG", &bgColorG) != XML_NO_ERROR
             || mWindowTag->QueryIntAttribute("bgColorB", &bgColorB) != XML_NO_ERROR)
-        e.throwError(L"parsing window size or background color attributes");
+        Engine::throwError(L"parsing window size or background color attributes");
     camSettings.mWindowSize = dimension2d<u32>(width, height);
     camSettings.mBgColor = SColor(bgColorA, bgColorR, bgColorG, bgColorB);
 
+    // Occlusion queries are optional
+    if(mWindowTag->QueryBoolAttribute("occlusion", &camSettings.mOcclusionQueries) == XML_WRONG_ATTRIBUTE_TYPE)
+        Engine::throwError(L"parsing window occlusion");
+
+    // Profile overlay is optional
+    if(mWindowTag->QueryBoolAttribute("profile", &camSettings.mDisplayProfile) == XML_WRONG_ATTRIBUTE_TYPE)
+        Engine::throwError(L"parsing window profile");
+
+    // Scrubbing cache is optional
+    if(mWindowTag->QueryIntAttribute("cache", &camSettings.mFrameCacheSize) == XML_WRONG_ATTRIBUTE_TYPE
+            || camSettings.mFrameCacheSize < 0)
+        Engine::throwError(L"parsing window cache");
+
     int guiColorA, guiColorR, guiColorG, guiColorB;
     camSettings.mFontGUIPath = mGuiTextTag->Attribute("font");
     if(camSettings.mFontGUIPath == nullptr
@@ -128,15 +115,19 @@ CameraSettings SettingsParser::retrieveCameraSettings()
             || mGuiTextTag->QueryIntAttribute("colorR", &guiColorR) != XML_NO_ERROR
             || mGuiTextTag->QueryIntAttribute("colorG", &guiColorG) != XML_NO_ERROR
             || mGuiTextTag->QueryIntAttribute("colorB", &guiColorB) != XML_NO_ERROR)
-        e.throwError(L"parsing gui text font or color tag");
+        Engine::throwError(L"parsing gui text font or color tag");
     camSettings.mGuiColor = SColor(guiColorA, guiColorR, guiColorG, guiColorB);
 
     if(mTransformationTag->QueryBoolAttribute("displayAxes", &camSettings.mDisplayAxes) != XML_NO_ERROR)
-        e.throwError(L"parsing displayAxes");
+        Engine::throwError(L"parsing displayAxes");
 
     if(mCameraTag->QueryFloatAttribute("fpsScale", &camSettings.mFpsScale) != XML_NO_ERROR
         || mCameraTag->QueryFloatAttribute("fov", &camSettings.mFieldOfView) != XML_NO_ERROR)
-        e.throwError(L"parsing fpsScale or fov");
+        Engine::throwError(L"parsing fpsScale or fov");
+
+    // Keyframed trajectory is optional
+    if(mCameraTag->QueryBoolAttribute("keyframes", &camSettings.mKeyframes) == XML_WRONG_ATTRIBUTE_TYPE)
+        Engine::throwError(L"parsing camera keyframes");
 
     int jTextColorA, jTextColorR, jTextColorG, jTextColorB;
     camSettings.mFontJerseyPath = mJerseysTag->Attribute("font");
@@ -145,7 +136,7 @@ CameraSettings SettingsParser::retrieveCameraSettings()
             || mJerseysTag->QueryIntAttribute("colorR", &jTextColorR) != XML_NO_ERROR
             || mJerseysTag->QueryIntAttribute("colorG", &jTextColorG) != XML_NO_ERROR
             || mJerseysTag->QueryIntAttribute("colorB", &jTextColorB) != XML_NO_ERROR)
-        e.throwError(L"parsing jersey font or color");
+        Engine::throwError(L"parsing jersey font or color");
     camSettings.mJerseyTextColor = SColor(jTextColorA, jTextColorR, jTextColorG, jTextColorB);
 
 
@@ -156,16 +147,57 @@ const char* SettingsParser::retrieveCameraTrajectoryPath()
 {
     auto cameraTrackingPath = mCameraTag->Attribute("trajectory");
     if(cameraTrackingPath == nullptr)
-        Engine::getInstance().throwError(L"parsing camera trajectory path");
+        Engine::throwError(L"parsing camera trajectory path");
 
     return cameraTrackingPath;
 }
 
+const char* SettingsParser::retrieveJerseyCachePath()
+{
+    // Cache is optional
+    auto jerseyCachePath = mJerseysTag->Attribute("cache");
+    if(jerseyCachePath == nullptr)
+        return "";
+
+    return jerseyCachePath;
+}
+
+std::vector<ViewSettings> SettingsParser::retrieveViewSettings()
+{
+    float mainFieldOfView = 0;
+    if(mCameraTag->QueryFloatAttribute("fov", &mainFieldOfView) != XML_NO_ERROR)
+        Engine::throwError(L"parsing camera fov");
+
+    std::vector<ViewSettings> views;
+    for(auto viewTag = mCameraTag->NextSiblingElement("camera"); viewTag != nullptr;
+        viewTag = viewTag->NextSiblingElement("camera")) {
+        ViewSettings viewSettings;
+
+        auto trajectoryAtt = viewTag->Attribute("trajectory");
+        auto outputAtt = viewTag->Attribute("output");
+        if(trajectoryAtt == nullptr || outputAtt == nullptr)
+            Engine::throwError(L"parsing additional camera trajectory or output");
+        viewSettings.mTrajectoryPath = trajectoryAtt;
+        viewSettings.mOutputName = outputAtt;
+
+        viewSettings.mFieldOfView = mainFieldOfView;
+        if(viewTag->QueryFloatAttribute("fov", &viewSettings.mFieldOfView) == XML_WRONG_ATTRIBUTE_TYPE)
+            Engine::throwError(L"parsing additional camera fov");
+
+        if(viewTag->QueryBoolAttribute("keyframes", &viewSettings.mKeyframes) == XML_WRONG_ATTRIBUTE_TYPE)
+            Engine::throwError(L"parsing additional camera keyframes");
+
+        views.push_back(viewSettings);
+    }
+
+    return views;
+}
+
 const char *SettingsParser::retrievePlayerTrajectoryPath()
 {
     auto playerTrackingPath = mTrackingTag->Attribute("players");
     if(playerTrackingPath == nullptr)
-        Engine::getInstance().throwError(L"parsing player trajectories path");
+        Engine::throwError(L"parsing player trajectories path");
 
     return playerTrackingPath;
 }
@@ -174,25 +206,23 @@ const char *SettingsParser::retrieveBallTrajectoryPath()
 {
     auto ballTrackingPath = mTrackingTag->Attribute("ball");
     if(ballTrackingPath == nullptr)
-        Engine::getInstance().throwError(L"parsing ball tracking path tag");
+        Engine::throwError(L"parsing ball tracking path tag");
 
     return ballTrackingPath;
 }
 
 std::map< int, std::pair<int, int> > SettingsParser::retrievePlayerToTeamAndJerseyNumber()
 {
-    Engine& e = Engine::getInstance();
-
     // Identify players by using team and jersey number
     const char* jerseyPath = mTrackingTag->Attribute("jerseys");
     if(jerseyPath == nullptr)
-        e.throwError(L"parsing jersey ID file path");
+        Engine::throwError(L"parsing jersey ID file path");
 
     // Identify players by using team and jersey number
     std::ifstream jerseyFile;
     jerseyFile.open(jerseyPath);
     if(!jerseyFile.is_open()) {
-        e.throwError(L"Jersey correspondance file cannot be opened");
+        Engine::throwError(L"Jersey correspondance file cannot be opened");
     }
 
     // Establish correspondance between player index and team/jersey
@@ -217,43 +247,41 @@ std::map< int, std::pair<int, int> > SettingsParser::retrievePlayerToTeamAndJers
 
 std::map<int, const char*> SettingsParser::retrieveTeamToTexture()
 {
-    Engine& e = Engine::getInstance();
-
     int teamRedNormal, teamBlueNormal, teamRedSpecial, teamBlueSpecial;
     if(mTeamsTag->QueryIntAttribute("redNormal", &teamRedNormal) != XML_NO_ERROR
             || mTeamsTag->QueryIntAttribute("blueNormal", &teamBlueNormal) != XML_NO_ERROR
             || mTeamsTag->QueryIntAttribute("redSpecial", &teamRedSpecial) != XML_NO_ERROR
             || mTeamsTag->QueryIntAttribute("blueSpecial", &teamBlueSpecial) != XML_NO_ERROR)
-        e.throwError(L"parsing team IDs");
+        Engine::throwError(L"parsing team IDs");
 
 
     auto redNormal = mPlayersTag->FirstChildElement("redNormal");
     if(redNormal == nullptr)
-        e.throwError(L"parsing redNormal tag");
+        Engine::throwError(L"parsing redNormal tag");
     auto playerTextureRedNormal = redNormal->Attribute("texture");
     if(playerTextureRedNormal == nullptr)
-        e.throwError(L"parsing redNormal texture path");
+        Engine::throwError(L"parsing redNormal texture path");
 
     auto blueNormal = mPlayersTag->FirstChildElement("blueNormal");
     if(blueNormal == nullptr)
-        e.throwError(L"parsing blueNormal tag");
+        Engine::throwError(L"parsing blueNormal tag");
     auto playerTextureBlueNormal = blueNormal->Attribute("texture");
     if(playerTextureBlueNormal == nullptr)
-        e.throwError(L"parsing blueNormal texture path");
+        Engine::throwError(L"parsing blueNormal texture path");
 
     auto redSpecial = mPlayersTag->FirstChildElement("redSpecial");
     if(redSpecial == nullptr)
-        e.throwError(L"parsing redSpecial tag");
+        Engine::throwError(L"parsing redSpecial tag");
     auto playerTextureRedSpecial = redSpecial->Attribute("texture");
     if(playerTextureRedSpecial == nullptr)
-        e.throwError(L"parsing redSpecial texture path");
+        Engine::throwError(L"parsing redSpecial texture path");
 
     auto blueSpecial = mPlayersTag->FirstChildElement("blueSpecial");
     if(blueSpecial == nullptr)
-        e.throwError(L"parsing blueSpecial tag");
+        Engine::throwError(L"parsing blueSpecial tag");
     auto playerTextureBlueSpecial = blueSpecial->Attribute("texture");
     if(playerTextureBlueSpecial == nullptr)
-        e.throwError(L"parsing blueSpecial texture path");
+        Engine::throwError(L"parsing blueSpecial texture path");
 
     std::map<int, const char*> teamToTexture;
     teamToTexture[teamRedNormal] = playerTextureRedNormal;
@@ -266,39 +294,81 @@ std::map<int, const char*> SettingsParser::retrieveTeamToTexture()
 
 SequenceSettings SettingsParser::retrieveSequenceSettings()
 {
-    Engine& e = Engine::getInstance();
     SequenceSettings sequenceSettings;
 
     int modeNumber = 0;
     if(mModeTag->QueryIntAttribute("type", &modeNumber) != XML_NO_ERROR)
-        e.throwError(L"parsing run mode");
+        Engine::throwError(L"parsing run mode");
 
     sequenceSettings.mMode = (RUN_MODE) modeNumber;
 
+    // Tracing is optional
+    auto traceAtt = mModeTag->Attribute("trace");
+    if(traceAtt != nullptr)
+        sequenceSettings.mTracePath = traceAtt;
+
     if(mImageTag->QueryIntAttribute("frameNumber", &sequenceSettings.mFrameNumber) != XML_NO_ERROR
             || mImageTag->QueryIntAttribute("frameRate", &sequenceSettings.mFramerate) != XML_NO_ERROR
             || mImageTag->QueryIntAttribute("current", &sequenceSettings.mInitialTime) != XML_NO_ERROR)
-        e.throwError(L"parsing frameNumber or frameRate or current frame");
+        Engine::throwError(L"parsing frameNumber or frameRate or current frame");
+
+    // Output frame rate is optional and defaults to the one of the sequence
+    sequenceSettings.mOutputFramerate = sequenceSettings.mFramerate;
+    if(mImageTag->QueryIntAttribute("outputFrameRate", &sequenceSettings.mOutputFramerate) == XML_WRONG_ATTRIBUTE_TYPE
+            || sequenceSettings.mOutputFramerate <= 0)
+        Engine::throwError(L"parsing output frame rate");
+
+    // Interpolation is optional and defaults to linear
+    auto interpolationAtt = mImageTag->Attribute("interpolation");
+    if(interpolationAtt == nullptr || strcmp(interpolationAtt, "linear") == 0) {
+        sequenceSettings.mInterpolation = INTERPOLATION_LINEAR;
+    } else if(strcmp(interpolationAtt, "catmull-rom") == 0) {
+        sequenceSettings.mInterpolation = INTERPOLATION_CATMULL_ROM;
+    } else {
+        Engine::throwError(L"parsing interpolation, must be linear or catmull-rom");
+    }
 
     auto videoNameAtt = mVideoTag->Attribute("name");
     if(videoNameAtt == nullptr)
-        e.throwError(L"parsing video output path");
+        Engine::throwError(L"parsing video output path");
     sequenceSettings.mVideoOutputName = videoNameAtt;
 
+    // Video format is optional and defaults to XviD
+    auto videoFormatAtt = mVideoTag->Attribute("format");
+    if(videoFormatAtt == nullptr || strcmp(videoFormatAtt, "xvid") == 0) {
+        sequenceSettings.mVideoFormat = FORMAT_XVID;
+    } else if(strcmp(videoFormatAtt, "i420") == 0) {
+        sequenceSettings.mVideoFormat = FORMAT_I420;
+    } else {
+        Engine::throwError(L"parsing video format, must be xvid or i420");
+    }
+
+    // Encoding threads, segment length and memory are optional, by default a single thread encodes the whole video
+    if(mVideoTag->QueryIntAttribute("threads", &sequenceSettings.mVideoThreads) == XML_WRONG_ATTRIBUTE_TYPE
+            || mVideoTag->QueryIntAttribute("segment", &sequenceSettings.mVideoSegmentLength) == XML_WRONG_ATTRIBUTE_TYPE
+            || mVideoTag->QueryIntAttribute("memory", &sequenceSettings.mVideoMemory) == XML_WRONG_ATTRIBUTE_TYPE
+            || sequenceSettings.mVideoThreads < 0 || sequenceSettings.mVideoSegmentLength < 0
+            || sequenceSettings.mVideoMemory <= 0)
+        Engine::throwError(L"parsing video encoding threads, segment length or memory");
+
+    // Checkpoints are optional, and disabled by default
+    if(mVideoTag->QueryIntAttribute("checkpoint", &sequenceSettings.mVideoCheckpointLength) == XML_WRONG_ATTRIBUTE_TYPE
+            || sequenceSettings.mVideoCheckpointLength < 0)
+        Engine::throwError(L"parsing video checkpoint length");
+
     if(mSequenceTag->QueryIntAttribute("start", &sequenceSettings.mStartTime) != XML_NO_ERROR
             || mSequenceTag->QueryIntAttribute("end", &sequenceSettings.mEndTime) != XML_NO_ERROR)
-        e.throwError(L"parsing sequence start or end time");
+        Engine::throwError(L"parsing sequence start or end time");
 
     if(mActionsTag->QueryIntAttribute("speedInterval", &sequenceSettings.mSpeedInterval) != XML_NO_ERROR
         || mActionsTag->QueryIntAttribute("avgNbPoints", &sequenceSettings.mNbPointsAverager) != XML_NO_ERROR)
-        e.throwError(L"parsing speed computation interval or number of points for averager");
+        Engine::throwError(L"parsing speed computation interval or number of points for averager");
 
     return sequenceSettings;
 }
 
 BodySettings SettingsParser::retrieveGeneralBodySettings()
 {
-    Engine& e = Engine::getInstance();
     BodySettings bodySettings;
 
     bodySettings.mTrajVisible = true;
@@ -308,15 +378,36 @@ BodySettings SettingsParser::retrieveGeneralBodySettings()
             || mColorCurvesTag->QueryIntAttribute("colorR", &trajR) != XML_NO_ERROR
             || mColorCurvesTag->QueryIntAttribute("colorG", &trajG) != XML_NO_ERROR
             || mColorCurvesTag->QueryIntAttribute("colorB", &trajB) != XML_NO_ERROR)
-        e.throwError(L"parsing color curves color or nbPoints");
+        Engine::throwError(L"parsing color curves color or nbPoints");
     bodySettings.mTrajColor = SColor(trajA, trajR, trajG, trajB);
 
+    // Fading is optional
+    if(mColorCurvesTag->QueryBoolAttribute("fade", &bodySettings.mTrajFade) == XML_WRONG_ATTRIBUTE_TYPE)
+        Engine::throwError(L"parsing color curves fade");
+
     return bodySettings;
 }
 
+void SettingsParser::retrieveLevelsOfDetail(XMLElement* bodyTag, BodySettings& bodySettings)
+{
+    // Levels of detail are optional, but a model or texture needs its size threshold
+    auto lodModelPath = bodyTag->Attribute("lodModel");
+    if(lodModelPath != nullptr) {
+        bodySettings.mLodModelPath = lodModelPath;
+        if(bodyTag->QueryFloatAttribute("lodSize", &bodySettings.mLodSize) != XML_NO_ERROR)
+            Engine::throwError(L"parsing decimated model size");
+    }
+
+    auto billboardPath = bodyTag->Attribute("billboard");
+    if(billboardPath != nullptr) {
+        bodySettings.mBillboardPath = billboardPath;
+        if(bodyTag->QueryFloatAttribute("billboardSize", &bodySettings.mBillboardSize) != XML_NO_ERROR)
+            Engine::throwError(L"parsing billboard size");
+    }
+}
+
 BodySettings SettingsParser::retrievePlayerBodySettings(const char* texturePath)
 {
-    Engine& e = Engine::getInstance();
     auto playerBodySettings = retrieveGeneralBodySettings();
     playerBodySettings.mTexturePath = "none";
 
@@ -324,10 +415,12 @@ BodySettings SettingsParser::retrievePlayerBodySettings(const char* texturePath)
     if(playerBodySettings.mModelPath == nullptr
             || mPlayersTag->QueryBoolAttribute("visible", &playerBodySettings.mVisible) != XML_NO_ERROR
             || mPlayersTag->QueryFloatAttribute("scale", &playerBodySettings.mScale) != XML_NO_ERROR)
-        e.throwError(L"parsing player model path or visibility or scale");
+        Engine::throwError(L"parsing player model path or visibility or scale");
 
     if(mColorCurvesTag->QueryBoolAttribute("playersVisible", &playerBodySettings.mTrajVisible) != XML_NO_ERROR)
-        e.throwError(L"parsing player color curve");
+        Engine::throwError(L"parsing player color curve");
+
+    retrieveLevelsOfDetail(mPlayersTag, playerBodySettings);
 
     playerBodySettings.mTexturePath = texturePath;
 
@@ -336,7 +429,6 @@ BodySettings SettingsParser::retrievePlayerBodySettings(const char* texturePath)
 
 BodySettings SettingsParser::retrieveBallBodySettings()
 {
-    Engine& e = Engine::getInstance();
     auto ballBodySettings = retrieveGeneralBodySettings();
 
     ballBodySettings.mModelPath = mBallTag->Attribute("model");
@@ -345,10 +437,12 @@ BodySettings SettingsParser::retrieveBallBodySettings()
             || ballBodySettings.mTexturePath == nullptr
             || mBallTag->QueryFloatAttribute("scale", &ballBodySettings.mScale) != XML_NO_ERROR
             || mBallTag->QueryBoolAttribute("visible", &ballBodySettings.mVisible) != XML_NO_ERROR)
-        e.throwError(L"parsing ball model path or texture path or visibility or scale");
+        Engine::throwError(L"parsing ball model path or texture path or visibility or scale");
 
     if(mColorCurvesTag->QueryBoolAttribute("ballVisible", &ballBodySettings.mTrajVisible) != XML_NO_ERROR)
-        e.throwError(L"parsing ball color curve visibility");
+        Engine::throwError(L"parsing ball color curve visibility");
+
+    retrieveLevelsOfDetail(mBallTag, ballBodySettings);
 
     return ballBodySettings;
 }
@@ -356,39 +450,42 @@ BodySettings SettingsParser::retrieveBallBodySettings()
 
 PlayerSettings SettingsParser::retrievePlayerSettings(int team, int jerseyNumber)
 {
-    Engine& e = Engine::getInstance();
     PlayerSettings playerSettings;
 
     auto stand = mActionsTag->FirstChildElement("stand");
     if(stand == nullptr)
-        e.throwError(L"parsing stand tag");
+        Engine::throwError(L"parsing stand tag");
     if(stand->QueryIntAttribute("begin", &playerSettings.mActions[AnimationAction::Stand].mBegin) != XML_NO_ERROR
         || stand->QueryIntAttribute("end", &playerSettings.mActions[AnimationAction::Stand].mEnd) != XML_NO_ERROR)
-        e.throwError(L"parsing stand sequence begin or end");
+        Engine::throwError(L"parsing stand sequence begin or end");
 
     auto walk = mActionsTag->FirstChildElement("walk");
     if(walk == nullptr)
-        e.throwError(L"parsing walk tag");
+        Engine::throwError(L"parsing walk tag");
     if(walk->QueryIntAttribute("begin", &playerSettings.mActions[AnimationAction::Walk].mBegin) != XML_NO_ERROR
         || walk->QueryIntAttribute("end", &playerSettings.mActions[AnimationAction::Walk].mEnd) != XML_NO_ERROR
         || walk->QueryFloatAttribute("threshold", &playerSettings.mActions[AnimationAction::Walk].mThreshold) != XML_NO_ERROR)
-        e.throwError(L"parsing walk sequence begin or end or threshold");
+        Engine::throwError(L"parsing walk sequence begin or end or threshold");
 
     auto run = mActionsTag->FirstChildElement("run");
     if(run == nullptr)
-        e.throwError(L"parsing run tag");
+        Engine::throwError(L"parsing run tag");
     if(run->QueryIntAttribute("begin", &playerSettings.mActions[AnimationAction::Run].mBegin) != XML_NO_ERROR
         || run->QueryIntAttribute("end", &playerSettings.mActions[AnimationAction::Run].mEnd) != XML_NO_ERROR
         || run->QueryFloatAttribute("threshold", &playerSettings.mActions[AnimationAction::Run].mThreshold) != XML_NO_ERROR)
-        e.throwError(L"parsing run sequence begin or end or threshold");
+        Engine::throwError(L"parsing run sequence begin or end or threshold");
 
     int playerTextureWidth, playerTextureHeight;
     if(mPlayersTag->QueryIntAttribute("frameRate", &playerSettings.mAnimFramerate) != XML_NO_ERROR
         || mPlayersTag->QueryIntAttribute("textureWidth", &playerTextureWidth) != XML_NO_ERROR
         || mPlayersTag->QueryIntAttribute("textureHeight", &playerTextureHeight) != XML_NO_ERROR)
-        e.throwError(L"parsing player animation frameRate or player texture width or height");
+        Engine::throwError(L"parsing player animation frameRate or player texture width or height");
     playerSettings.mTextureSize = dimension2d<u32>(playerTextureWidth, playerTextureHeight);
 
+    // Saving baked poses is optional
+    if(mPlayersTag->QueryBoolAttribute("savePoses", &playerSettings.mArePosesSaved) == XML_WRONG_ATTRIBUTE_TYPE)
+        Engine::throwError(L"parsing player savePoses");
+
     int jerseyNumberLeft, jerseyNumberTop, jerseyNumberRight, jerseyNumberBottom;
     int jTextColorA, jTextColorR, jTextColorG, jTextColorB;
     if(mJerseysTag->QueryIntAttribute("rectLeft", &jerseyNumberLeft) != XML_NO_ERROR
@@ -399,7 +496,7 @@ PlayerSettings SettingsParser::retrievePlayerSettings(int team, int jerseyNumber
         || mJerseysTag->QueryIntAttribute("colorR", &jTextColorR) != XML_NO_ERROR
         || mJerseysTag->QueryIntAttribute("colorG", &jTextColorG) != XML_NO_ERROR
         || mJerseysTag->QueryIntAttribute("colorB", &jTextColorB) != XML_NO_ERROR)
-        e.throwError(L"parsing jersey rectangle or color");
+        Engine::throwError(L"parsing jersey rectangle or color");
     playerSettings.mJerseyTextRect = recti(jerseyNumberLeft, jerseyNumberTop, jerseyNumberRight, jerseyNumberBottom);
 
     playerSettings.mJerseyNumber = jerseyNumber;
@@ -410,8 +507,6 @@ PlayerSettings SettingsParser::retrievePlayerSettings(int team, int jerseyNumber
 
 std::pair<vector3df, vector3df> SettingsParser::retrieveAffineTransformationPair()
 {
-    Engine& e = Engine::getInstance();
-
     auto tfm = mTransformationTag;
     float tfmScaleX, tfmScaleY, tfmScaleZ, tfmOffsetX, tfmOffsetY, tfmOffsetZ;
     if(tfm->QueryFloatAttribute("scaleX", &tfmScaleX) != XML_NO_ERROR
@@ -420,7 +515,7 @@ std::pair<vector3df, vector3df> SettingsParser::retrieveAffineTransformationPair
             || tfm->QueryFloatAttribute("offsetX", &tfmOffsetX) != XML_NO_ERROR
             || tfm->QueryFloatAttribute("offsetY", &tfmOffsetY) != XML_NO_ERROR
             || tfm->QueryFloatAttribute("offsetZ", &tfmOffsetZ) != XML_NO_ERROR)
-        e.throwError(L"parsing transformation scale and offset attributes");
+        Engine::throwError(L"parsing transformation scale and offset attributes");
 
     const vector3df tfmScale(tfmScaleX, tfmScaleY, tfmScaleZ);
     const vector3df tfmOffset(tfmOffsetX, tfmOffsetY, tfmOffsetZ);
@@ -433,84 +528,76 @@ std::pair<vector3df, vector3df> SettingsParser::retrieveAffineTransformationPair
 
 void SettingsParser::exploreGraphicsTag()
 {
-    Engine& e = Engine::getInstance();
-
     mModeTag = mGraphicsTag->FirstChildElement("mode");
     if(mModeTag == nullptr)
-        e.throwError(L"parsing mode tag");
+        Engine::throwError(L"parsing mode tag");
 
     mWindowTag = mGraphicsTag->FirstChildElement("window");
     if(mWindowTag == nullptr)
-        e.throwError(L"parsing window tag");
+        Engine::throwError(L"parsing window tag");
 
     mGuiTextTag = mGraphicsTag->FirstChildElement("guitext");
     if(mGuiTextTag == nullptr)
-        e.throwError(L"parsing guitext tag");
+        Engine::throwError(L"parsing guitext tag");
 }
 
 void SettingsParser::exploreInputTag()
 {
-    Engine& e = Engine::getInstance();
-
     mImageTag = mInputTag->FirstChildElement("image");
     if(mImageTag == nullptr)
-        e.throwError(L"parsing image tag");
+        Engine::throwError(L"parsing image tag");
 
     mTrackingTag = mInputTag->FirstChildElement("tracking");
     if(mTrackingTag == nullptr)
-        e.throwError(L"parsing tracking tag");
+        Engine::throwError(L"parsing tracking tag");
 
     mTeamsTag = mInputTag->FirstChildElement("teams");
     if(mTeamsTag == nullptr)
-        e.throwError(L"parsing teams tag");
+        Engine::throwError(L"parsing teams tag");
 
     mTransformationTag = mInputTag->FirstChildElement("transformation");
     if(mTransformationTag == nullptr)
-        e.throwError(L"parsing transformation tag");
+        Engine::throwError(L"parsing transformation tag");
 }
 
 void SettingsParser::exploreOutputTag()
 {
-    Engine& e = Engine::getInstance();
-
     mVideoTag = mOutputTag->FirstChildElement("video");
     if(mVideoTag == nullptr)
-        e.throwError(L"parsing video tag");
+        Engine::throwError(L"parsing video tag");
 
     mSequenceTag = mOutputTag->FirstChildElement("sequence");
     if(mSequenceTag == nullptr)
-        e.throwError(L"parsing sequence tag");
+        Engine::throwError(L"parsing sequence tag");
 
     mCameraTag = mOutputTag->FirstChildElement("camera");
     if(mCameraTag == nullptr)
-        e.throwError(L"parsing camera tag");
+        Engine::throwError(L"parsing camera tag");
 }
 
 void SettingsParser::exploreAvatarsTag()
 {
-    Engine& e = Engine::getInstance();
-
     mSceneTag = mAvatarsTag->FirstChildElement("scene");
     if(mSceneTag == nullptr)
-        e.throwError(L"parsing scene tag");
+        Engine::throwError(L"parsing scene tag");
 
     mActionsTag = mAvatarsTag->FirstChildElement("actions");
     if(mActionsTag == nullptr)
-        e.throwError(L"parsing actions tag");
+        Engine::throwError(L"parsing actions tag");
 
     mPlayersTag = mAvatarsTag->FirstChildElement("players");
     if(mPlayersTag == nullptr)
-        e.throwError(L"parsing players tag");
+        Engine::throwError(L"parsing players tag");
 
     mJerseysTag = mAvatarsTag->FirstChildElement("jerseys");
     if(mJerseysTag == nullptr)
-        e.throwError(L"parsing jerseys tag");
+        Engine::throwError(L"parsing jerseys tag");
 
     mBallTag = mAvatarsTag->FirstChildElement("ball");
     if(mBallTag == nullptr)
-        e.throwError(L"parsing ball tag");
+        Engine::throwError(L"parsing ball tag");
 
     mColorCurvesTag = mAvatarsTag->FirstChildElement("colorcurves");
     if(mColorCurvesTag == nullptr)
-        e.throwError(L"parsing colorcurves tag");
+        Engine::throwError(L"parsing colorcurves tag");
 }
@@ -20,10 +20,12 @@
 #define SETTINGSPARSER_H
 
 #include <tuple>
+#include <vector>
 #include "libs/tinyxml2.h"
 #include "courtsettings.h"
 #include "camerasettings.h"
 #include "bodysettings.h"
+#include "viewsettings.h"
 
 using namespace tinyxml2;
 using namespace irr::core;
@@ -112,37 +114,29 @@ public:
     const char* retrieveCameraTrajectoryPath();
 
     /**
-     * Returns path to player trajectory file
-     * @return path
+     * Returns directory where jersey atlases are cached
+     * @return path, or empty string if jersey atlases are not cached
      */
-    const char* retrievePlayerTrajectoryPath();
-
-    /**
-     * Returns path to ball trajectory file
-     * @return path
-     */
-    const char* retrieveBallTrajectoryPath();
+    const char* retrieveJerseyCachePath();
 
     /**
-     * Returns player trajectory tokens in this order: frame index -> player index -> position vector.
-     * @param line line to parse
-     * @return tokens
+     * Returns the settings of the cameras following the first camera tag. Their field of view defaults to
+     * the one of the first camera.
+     * @return settings of additional cameras, possibly empty
      */
-    static std::tuple<int, int, vector2df > getPlayerTokens(const std::string& line);
+    std::vector<ViewSettings> retrieveViewSettings();
 
     /**
-     * Returns ball trajectory tokens in this order: frame index -> position vector.
-     * @param line line to parse
-     * @return tokens
+     * Returns path to player trajectory file
+     * @return path
      */
-    static std::tuple<int, vector3df > getBallTokens(const std::string& line);
+    const char* retrievePlayerTrajectoryPath();
 
     /**
-     * Returns camera trajectory tokens in this order: frame index -> position vector -> rotation vector.
-     * @param line line to parse
-     * @return tokens
+     * Returns path to ball trajectory file
+     * @return path
      */
-    static std::tuple<int, vector3df, vector3df > getCameraTokens(const std::string& line);
+    const char* retrieveBallTrajectoryPath();
 
 private:
 
@@ -155,6 +149,13 @@ private:
      */
     BodySettings retrieveGeneralBodySettings();
 
+    /**
+     * Completes body settings with the optional decimated model and billboard of a body tag
+     * @param bodyTag players or ball tag
+     * @param bodySettings body settings to complete
+     */
+    void retrieveLevelsOfDetail(XMLElement* bodyTag, BodySettings& bodySettings);
+
     // XMLElement shortcut creators
     void exploreGraphicsTag();
     void exploreInputTag();
@@ -0,0 +1,183 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include "engine.h"
+#include "tracerecorder.h"
+
+namespace
+{
+    // Protects the list of buffers and the output name, not the events which belong to their thread
+    std::mutex buffersMutex;
+    std::atomic<bool> isStarted(false);
+    std::string outputName;
+    std::chrono::steady_clock::time_point origin;
+    int nextThreadId = 1;
+
+    // Kept without a buffer, so that threads running while no trace is recorded allocate nothing
+    thread_local const char* threadName = "thread";
+    thread_local int threadFrame = -1;
+}
+
+TraceRecorder::Span::Span(const char* name)
+    : mName(name), mBegin(isRecording() ? getTimestamp() : -1)
+{
+}
+
+TraceRecorder::Span::~Span()
+{
+    // Spans begun before the start of the recording are dropped
+    if(mBegin < 0 || !isRecording())
+        return;
+
+    auto& buffer = getBuffer();
+    Event event = { mName, 'X', mBegin, getTimestamp() - mBegin, threadFrame, 0 };
+    buffer.mEvents.push_back(event);
+}
+
+void TraceRecorder::start(const std::string& fileName)
+{
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    // Threads of previous recordings, such as encoders, would otherwise accumulate in long-running processes
+    auto& buffers = getBuffers();
+    buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                                 [](const std::unique_ptr<Buffer>& buffer) { return buffer->mIsThreadFinished; }),
+                  buffers.end());
+    for(auto& buffer : buffers)
+        buffer->mEvents.clear();
+    outputName = fileName;
+    origin = std::chrono::steady_clock::now();
+    isStarted = true;
+}
+
+void TraceRecorder::stop()
+{
+    if(!isStarted)
+        return;
+    isStarted = false;
+
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    std::ofstream file(outputName.c_str());
+    if(!file.is_open())
+        Engine::throwError(L"Trace file cannot be opened");
+
+    // Timestamps are in microseconds, with a fraction for sub-microsecond spans
+    file.setf(std::ios_base::fixed);
+    file.precision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool isFirst = true;
+    for(auto& buffer : getBuffers()) {
+        file << (isFirst ? "\n" : ",\n");
+        isFirst = false;
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->mThreadId
+             << ",\"args\":{\"name\":\"" << buffer->mThreadName << "\"}}";
+
+        for(auto& event : buffer->mEvents) {
+            file << ",\n{\"name\":\"" << event.mName << "\",\"ph\":\"" << event.mPhase
+                 << "\",\"pid\":1,\"tid\":" << buffer->mThreadId << ",\"ts\":" << event.mTimestamp;
+            if(event.mPhase == 'X') {
+                file << ",\"dur\":" << event.mDuration;
+                if(event.mFrame >= 0)
+                    file << ",\"args\":{\"frame\":" << event.mFrame << "}";
+            } else {
+                file << ",\"args\":{\"value\":" << event.mValue << "}";
+            }
+            file << "}";
+        }
+        buffer->mEvents.clear();
+    }
+    file << "\n]}\n";
+
+    if(!file.good())
+        Engine::throwError(L"Trace file could not be written");
+}
+
+bool TraceRecorder::isRecording()
+{
+    return isStarted;
+}
+
+void TraceRecorder::setThreadName(const char* name)
+{
+    threadName = name;
+}
+
+void TraceRecorder::setFrame(int frame)
+{
+    threadFrame = frame;
+}
+
+void TraceRecorder::addCounter(const char* name, double value)
+{
+    if(!isRecording())
+        return;
+
+    auto& buffer = getBuffer();
+    Event event = { name, 'C', getTimestamp(), 0, threadFrame, value };
+    buffer.mEvents.push_back(event);
+}
+
+TraceRecorder::Buffer& TraceRecorder::getBuffer()
+{
+    // Marks the buffer when its thread exits, so that start() can drop it
+    struct BufferOwner
+    {
+        Buffer* mBuffer;
+
+        ~BufferOwner()
+        {
+            if(mBuffer == nullptr)
+                return;
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            mBuffer->mIsThreadFinished = true;
+        }
+    };
+
+    // Each thread registers its buffer once, then adds events without locking
+    thread_local BufferOwner owner = { nullptr };
+    if(owner.mBuffer == nullptr) {
+        Buffer* buffer = new Buffer();
+        buffer->mIsThreadFinished = false;
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffer->mThreadId = nextThreadId++;
+        getBuffers().push_back(std::unique_ptr<Buffer>(buffer));
+        owner.mBuffer = buffer;
+    }
+
+    // Name may have been given before the buffer existed, or changed since
+    owner.mBuffer->mThreadName = threadName;
+    return *owner.mBuffer;
+}
+
+std::vector<std::unique_ptr<TraceRecorder::Buffer>>& TraceRecorder::getBuffers()
+{
+    // Buffers outlive their thread, so that events of finished encoders are written
+    static std::vector<std::unique_ptr<Buffer>> buffers;
+    return buffers;
+}
+
+double TraceRecorder::getTimestamp()
+{
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - origin;
+    return elapsed.count();
+}
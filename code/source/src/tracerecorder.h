@@ -0,0 +1,130 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <vector>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Records a timeline of the engine activity as a Chrome trace-event JSON file
+ *
+ * Class only with static methods. While recording is started, spans and counters are appended to a buffer of
+ * the calling thread, and the whole timeline is written when recording stops. The file opens in
+ * chrome://tracing or in Perfetto, with a track per thread. Events carry the frame given to setFrame() on
+ * their thread, if any. A thread only gets a buffer when it records an event, and buffers of finished threads
+ * are dropped by the next start(), once their events have been written.
+ */
+class TraceRecorder
+{
+
+public:
+
+    /**
+     * @brief Records the time spent in a scope as a span of the timeline
+     */
+    class Span
+    {
+
+    public:
+
+        /**
+         * Starts a span, if recording is started
+         * @param name name of the span, which must be a string literal
+         */
+        explicit Span(const char* name);
+
+        /**
+         * Adds the span to the buffer of the thread
+         */
+        ~Span();
+
+    private:
+
+        Span& operator= (const Span&);
+        Span(const Span&);
+
+        const char* mName;
+        double mBegin;
+    };
+
+    /**
+     * Starts recording. Events of a previous recording which was not stopped are discarded.
+     * @param fileName JSON file written by stop()
+     */
+    static void start(const std::string& fileName);
+
+    /**
+     * Stops recording and writes the timeline. Must not be called while other threads are recording events.
+     */
+    static void stop();
+
+    /**
+     * Tells whether events are recorded
+     * @return true if recording is started
+     */
+    static bool isRecording();
+
+    /**
+     * Names the track of the calling thread
+     * @param name name of the thread, which must be a string literal
+     */
+    static void setThreadName(const char* name);
+
+    /**
+     * Attaches a frame index to the next events of the calling thread
+     * @param frame frame index, or -1 for none
+     */
+    static void setFrame(int frame);
+
+    /**
+     * Adds the value of a counter at the current time
+     * @param name name of the counter, which must be a string literal
+     * @param value value of the counter
+     */
+    static void addCounter(const char* name, double value);
+
+private:
+
+    struct Event
+    {
+        const char* mName;
+        char mPhase;
+        double mTimestamp;
+        double mDuration;
+        int mFrame;
+        double mValue;
+    };
+
+    struct Buffer
+    {
+        int mThreadId;
+        const char* mThreadName;
+        bool mIsThreadFinished;
+        std::vector<Event> mEvents;
+    };
+
+    static Buffer& getBuffer();
+    static std::vector<std::unique_ptr<Buffer>>& getBuffers();
+    static double getTimestamp();
+
+};
+
+#endif // TRACERECORDER_H
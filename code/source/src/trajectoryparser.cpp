@@ -0,0 +1,42 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "science.h"
+#include "trajectoryparser.h"
+
+std::tuple<int, int, vector2df> TrajectoryParser::getPlayerTokens(const std::string &line)
+{
+    auto strTokens = Science::split(line);
+    return std::make_tuple(std::stoi(strTokens.at(0)), std::stoi(strTokens.at(1)),
+                           vector2df(std::stof(strTokens.at(2)), std::stof(strTokens.at(3))));
+}
+
+std::tuple<int, vector3df> TrajectoryParser::getBallTokens(const std::string &line)
+{
+    auto strTokens = Science::split(line);
+    return std::make_tuple(std::stoi(strTokens.at(0)),
+                           vector3df(std::stof(strTokens.at(1)), std::stof(strTokens.at(2)), std::stof(strTokens.at(3))));
+}
+
+std::tuple<int, vector3df, vector3df> TrajectoryParser::getCameraTokens(const std::string &line)
+{
+    auto strTokens = Science::split(line);
+    return std::make_tuple(std::stoi(strTokens.at(0)),
+                           vector3df(std::stof(strTokens.at(1)), std::stof(strTokens.at(2)), std::stof(strTokens.at(3))),
+                           vector3df(std::stof(strTokens.at(4)), std::stof(strTokens.at(5)), std::stof(strTokens.at(6))));
+}
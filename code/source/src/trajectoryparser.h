@@ -0,0 +1,60 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRAJECTORYPARSER_H
+#define TRAJECTORYPARSER_H
+
+#include <tuple>
+#include <string>
+#include <irrlicht.h>
+
+using namespace irr::core;
+
+/**
+ * Class only with static methods, to parse the lines of trajectory files. Malformed lines throw the
+ * exceptions of std::stoi and std::stof.
+ */
+class TrajectoryParser
+{
+
+public:
+
+    /**
+     * Returns player trajectory tokens in this order: frame index -> player index -> position vector.
+     * @param line line to parse
+     * @return tokens
+     */
+    static std::tuple<int, int, vector2df > getPlayerTokens(const std::string& line);
+
+    /**
+     * Returns ball trajectory tokens in this order: frame index -> position vector.
+     * @param line line to parse
+     * @return tokens
+     */
+    static std::tuple<int, vector3df > getBallTokens(const std::string& line);
+
+    /**
+     * Returns camera trajectory tokens in this order: frame index -> position vector -> rotation vector.
+     * @param line line to parse
+     * @return tokens
+     */
+    static std::tuple<int, vector3df, vector3df > getCameraTokens(const std::string& line);
+
+};
+
+#endif // TRAJECTORYPARSER_H
@@ -0,0 +1,45 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include "trajectorywriter.h"
+
+// Lines are formatted in a buffer, which is much faster than formatting each value with the stream
+
+void TrajectoryWriter::writePlayerLine(std::ostream& out, int frame, int player, const vector2df& position)
+{
+    char line[128];
+    int length = snprintf(line, sizeof(line), "%d %d %.7g %.7g\n", frame, player, position.X, position.Y);
+    out.write(line, length);
+}
+
+void TrajectoryWriter::writeBallLine(std::ostream& out, int frame, const vector3df& position)
+{
+    char line[128];
+    int length = snprintf(line, sizeof(line), "%d %.7g %.7g %.7g\n", frame, position.X, position.Y, position.Z);
+    out.write(line, length);
+}
+
+void TrajectoryWriter::writeCameraLine(std::ostream& out, int frame, const vector3df& position,
+                                       const vector3df& rotation)
+{
+    char line[192];
+    int length = snprintf(line, sizeof(line), "%d %.7g %.7g %.7g %.7g %.7g %.7g\n", frame,
+                          position.X, position.Y, position.Z, rotation.X, rotation.Y, rotation.Z);
+    out.write(line, length);
+}
@@ -0,0 +1,64 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRAJECTORYWRITER_H
+#define TRAJECTORYWRITER_H
+
+#include <ostream>
+#include <irrlicht.h>
+
+using namespace irr::core;
+
+/**
+ * Class only with static methods, to write the lines of trajectory files in the format read by
+ * TrajectoryParser. Values are written with the 7 significant digits of a float.
+ * @see TrajectoryParser
+ */
+class TrajectoryWriter
+{
+
+public:
+
+    /**
+     * Writes a player trajectory line: frame index, player index, position
+     * @param out stream to write to
+     * @param frame frame index
+     * @param player player index
+     * @param position position on the ground
+     */
+    static void writePlayerLine(std::ostream& out, int frame, int player, const vector2df& position);
+
+    /**
+     * Writes a ball trajectory line: frame index, position
+     * @param out stream to write to
+     * @param frame frame index
+     * @param position position
+     */
+    static void writeBallLine(std::ostream& out, int frame, const vector3df& position);
+
+    /**
+     * Writes a camera trajectory line: frame index, position, rotation
+     * @param out stream to write to
+     * @param frame frame index
+     * @param position position
+     * @param rotation rotation in degrees
+     */
+    static void writeCameraLine(std::ostream& out, int frame, const vector3df& position, const vector3df& rotation);
+};
+
+#endif // TRAJECTORYWRITER_H
@@ -16,6 +16,9 @@
  *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cmath>
+#include <algorithm>
+
 #include "vectorsequence.h"
 
 VectorSequence::VectorSequence()
@@ -49,10 +52,51 @@ const vector3df VectorSequence::get(int time) const
     }
 }
 
+const vector3df VectorSequence::getLinear(double time) const
+{
+    int previous = (int) std::floor(time);
+    float ratio = (float) (time - previous);
+    return get(previous).getInterpolated(get(previous + 1), 1 - ratio);
+}
+
+const vector3df VectorSequence::getCatmullRom(double time) const
+{
+    int previous = (int) std::floor(time);
+    float t = (float) (time - previous);
+
+    // Before the beginning, the first vector is repeated instead of the origin returned by get()
+    vector3df p0 = get(std::max(previous - 1, getBegin()));
+    vector3df p1 = get(previous);
+    vector3df p2 = get(previous + 1);
+    vector3df p3 = get(previous + 2);
+
+    return (p1 * 2
+            + (p2 - p0) * t
+            + (p0 * 2 - p1 * 5 + p2 * 4 - p3) * (t * t)
+            + (p1 * 3 - p0 - p2 * 3 + p3) * (t * t * t)) * 0.5f;
+}
+
+const vector3df VectorSequence::getSlerp(double time) const
+{
+    int previous = (int) std::floor(time);
+    float ratio = (float) (time - previous);
+
+    quaternion from(get(previous) * DEGTORAD);
+    quaternion to(get(previous + 1) * DEGTORAD);
+    quaternion rotation;
+    rotation.slerp(from, to, ratio);
+
+    vector3df euler;
+    rotation.toEuler(euler);
+    return euler * RADTODEG;
+}
+
 int VectorSequence::getEnd() const
 {
-    int end = mTimeToVector.end()->first - 1;
-    return end;
+    if(mTimeToVector.empty())
+        return -1;
+
+    return mTimeToVector.rbegin()->first;
 }
 
 int VectorSequence::getBegin() const
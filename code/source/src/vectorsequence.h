@@ -57,9 +57,33 @@ public:
      */
     const vector3df get(int time) const;
 
+    /**
+     * Returns 3D vector between two frames, on the segment joining the vectors of the surrounding frames
+     * @param time fractional frame index
+     * @return 3D vector
+     */
+    const vector3df getLinear(double time) const;
+
+    /**
+     * Returns 3D vector between two frames, on the Catmull-Rom spline going through the vectors of the
+     * frames. The curve also depends on the frames before and after the surrounding ones, so that speed
+     * does not change abruptly at each frame.
+     * @param time fractional frame index
+     * @return 3D vector
+     */
+    const vector3df getCatmullRom(double time) const;
+
+    /**
+     * Returns rotation between two frames, for sequences of Euler angles in degrees. Rotations are
+     * interpolated as quaternions, so that the shortest way is taken even across 0 or 360 degrees.
+     * @param time fractional frame index
+     * @return rotation in degrees
+     */
+    const vector3df getSlerp(double time) const;
+
     /**
      * Returns end of sequence
-     * @return end index
+     * @return end index, or -1 if the sequence is empty
      */
     int getEnd() const;
 
@@ -0,0 +1,71 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+#include "engine.h"
+#include "aviwriter.h"
+#include "avireader.h"
+#include "videojoiner.h"
+
+void VideoJoiner::join(const std::vector<std::string>& segmentNames, const std::string& outputName,
+                       VIDEO_FORMAT format, int width, int height, int framerate)
+{
+    if(format == FORMAT_I420) {
+        joinRaw(segmentNames, outputName);
+    } else {
+        joinAvi(segmentNames, outputName, width, height, framerate);
+    }
+}
+
+void VideoJoiner::joinAvi(const std::vector<std::string>& segmentNames, const std::string& outputName,
+                          int width, int height, int framerate)
+{
+    AviWriter writer(outputName, width, height, framerate, "XVID");
+
+    std::vector<unsigned char> data;
+    for(auto& segmentName : segmentNames) {
+        AviReader reader(segmentName);
+        for(int i = 0; i < reader.getFrameCount(); ++i) {
+            bool isKeyframe = false;
+            reader.readFrame(i, data, isKeyframe);
+            writer.writeFrame(data.data(), data.size(), isKeyframe);
+        }
+    }
+
+    writer.close();
+}
+
+void VideoJoiner::joinRaw(const std::vector<std::string>& segmentNames, const std::string& outputName)
+{
+    std::ofstream output(outputName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!output.is_open()) {
+        Engine::throwError(L"Raw video output file cannot be opened");
+    }
+
+    for(auto& segmentName : segmentNames) {
+        std::ifstream segment(segmentName.c_str(), std::ios::in | std::ios::binary);
+        if(!segment.is_open()) {
+            Engine::throwError(L"Raw video segment cannot be opened");
+        }
+        output << segment.rdbuf();
+    }
+
+    if(!output.good()) {
+        Engine::throwError(L"Raw video segments could not be joined");
+    }
+}
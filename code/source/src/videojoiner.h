@@ -0,0 +1,57 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VIDEOJOINER_H
+#define VIDEOJOINER_H
+
+#include <string>
+#include <vector>
+#include "sequencesettings.h"
+
+/**
+ * @brief Assembles the segment files of a checkpointed recording into the final video
+ *
+ * AVI segments start with a keyframe, so their compressed frames are copied one after the other into a
+ * new AVI file without being decoded again. Raw I420 segments are simply concatenated.
+ */
+class VideoJoiner
+{
+
+public:
+
+    /**
+     * Writes the final video from its segments
+     * @param segmentNames segment files, in the order of the recording
+     * @param outputName final video file
+     * @param format format of the segments and of the final video
+     * @param width frame width
+     * @param height frame height
+     * @param framerate frame rate of the video
+     */
+    static void join(const std::vector<std::string>& segmentNames, const std::string& outputName,
+                     VIDEO_FORMAT format, int width, int height, int framerate);
+
+private:
+
+    static void joinAvi(const std::vector<std::string>& segmentNames, const std::string& outputName,
+                        int width, int height, int framerate);
+
+    static void joinRaw(const std::vector<std::string>& segmentNames, const std::string& outputName);
+};
+
+#endif // VIDEOJOINER_H
@@ -0,0 +1,51 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VIDEOSINK_H
+#define VIDEOSINK_H
+
+#include "yuvconverter.h"
+
+/**
+ * @brief Interface for the destinations of recorded frames
+ *
+ * Receives the I420 frames rendered by Engine::saveVideo() one after the other.
+ */
+class VideoSink
+{
+
+public:
+
+    /**
+     * Releases sink resources
+     */
+    virtual ~VideoSink() {}
+
+    /**
+     * Abstract method to append a frame to the output
+     * @param frame converted frame
+     */
+    virtual void writeFrame(const YuvConverter& frame) = 0;
+
+    /**
+     * Abstract method to finalize the output once all the frames have been written
+     */
+    virtual void finish() = 0;
+};
+
+#endif // VIDEOSINK_H
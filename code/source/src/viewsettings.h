@@ -0,0 +1,64 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VIEWSETTINGS_H
+#define VIEWSETTINGS_H
+
+#include <string>
+
+/**
+ * @brief Additional camera settings
+ *
+ * Contains the properties of a camera recorded besides the main camera of the window, each to its own output.
+ */
+class ViewSettings
+{
+public:
+
+    /**
+     * Creates an empty object with default values
+     */
+    ViewSettings() {
+        mTrajectoryPath = "";
+        mOutputName = "";
+        mFieldOfView = 0.0;
+        mKeyframes = false;
+    }
+
+    /**
+     * Path to camera trajectory file
+     */
+    std::string mTrajectoryPath;
+
+    /**
+     * Name of the video file recorded with this camera
+     */
+    std::string mOutputName;
+
+    /**
+     * Field of view of the camera
+     */
+    float mFieldOfView;
+
+    /**
+     * Specifies whether the trajectory file only gives keyframes, joined by a spline
+     */
+    bool mKeyframes;
+};
+
+#endif // VIEWSETTINGS_H
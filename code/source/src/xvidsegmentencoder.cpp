@@ -0,0 +1,109 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <mutex>
+#include <xvid.h>
+#include "xvidsegmentencoder.h"
+#include "engine.h"
+#include "frameprofiler.h"
+#include "tracerecorder.h"
+
+XvidSegmentEncoder::XvidSegmentEncoder(int width, int height, int framerate, int maxKeyInterval)
+{
+    initializeLibrary();
+
+    mWidth = width;
+    mHeight = height;
+    mIsFirstFrame = true;
+    // Same worst case bitstream size as in XviD examples
+    mBitstream.resize(width * height * 6);
+
+    xvid_enc_create_t create;
+    memset(&create, 0, sizeof(create));
+    create.version = XVID_VERSION;
+    create.width = width;
+    create.height = height;
+    create.fincr = 1;
+    create.fbase = framerate;
+    create.max_key_interval = maxKeyInterval;
+    create.max_bframes = 0;
+    // Parallelism comes from the segments, each instance works on a single thread
+    create.num_threads = 0;
+    create.global = XVID_GLOBAL_CLOSED_GOP;
+
+    if(xvid_encore(nullptr, XVID_ENC_CREATE, &create, nullptr) < 0) {
+        Engine::throwError(L"XviD encoder could not be created");
+    }
+    mHandle = create.handle;
+}
+
+XvidSegmentEncoder::~XvidSegmentEncoder()
+{
+    xvid_encore(mHandle, XVID_ENC_DESTROY, nullptr, nullptr);
+}
+
+void XvidSegmentEncoder::encode(const unsigned char* i420, std::vector<unsigned char>& packet, bool& isKeyframe)
+{
+    xvid_enc_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.version = XVID_VERSION;
+    frame.bitstream = mBitstream.data();
+    frame.length = -1;
+
+    frame.input.csp = XVID_CSP_I420;
+    frame.input.plane[0] = const_cast<unsigned char*>(i420);
+    frame.input.stride[0] = mWidth;
+
+    // No rate control plugin: a fixed low quantizer keeps the best quality, like the Revel path
+    frame.type = mIsFirstFrame ? XVID_TYPE_IVOP : XVID_TYPE_AUTO;
+    frame.quant = 2;
+    frame.vop_flags = XVID_VOP_HALFPEL | XVID_VOP_INTER4V | XVID_VOP_TRELLISQUANT;
+    frame.motion = XVID_ME_ADVANCEDDIAMOND16 | XVID_ME_HALFPELREFINE16 | XVID_ME_EXTSEARCH16
+            | XVID_ME_HALFPELREFINE8;
+
+    xvid_enc_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.version = XVID_VERSION;
+
+    int size;
+    {
+        // Measured on the encoding thread
+        FrameProfiler::ScopedTimer timer(FrameProfiler::STAGE_ENCODING);
+        TraceRecorder::Span span("encode");
+        size = xvid_encore(mHandle, XVID_ENC_ENCODE, &frame, &stats);
+    }
+    if(size < 0) {
+        Engine::throwError(L"XviD could not encode a frame");
+    }
+
+    packet.assign(mBitstream.begin(), mBitstream.begin() + size);
+    isKeyframe = (frame.out_flags & XVID_KEYFRAME) != 0;
+    mIsFirstFrame = false;
+}
+
+void XvidSegmentEncoder::initializeLibrary()
+{
+    static std::once_flag initFlag;
+    std::call_once(initFlag, []() {
+        xvid_gbl_init_t init;
+        memset(&init, 0, sizeof(init));
+        init.version = XVID_VERSION;
+        xvid_global(nullptr, XVID_GBL_INIT, &init, nullptr);
+    });
+}
@@ -0,0 +1,72 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XVIDSEGMENTENCODER_H
+#define XVIDSEGMENTENCODER_H
+
+#include <vector>
+
+/**
+ * @brief XviD encoder instance for a closed group of pictures
+ *
+ * The first frame given to an instance is forced to be a keyframe and B-frames are disabled, so that the
+ * compressed segment does not reference anything outside of it. Several instances can therefore encode
+ * consecutive parts of a video at the same time.
+ */
+class XvidSegmentEncoder
+{
+
+public:
+
+    /**
+     * Creates the XviD encoder instance
+     * @param width frame width
+     * @param height frame height
+     * @param framerate frame rate of the video
+     * @param maxKeyInterval maximal number of frames between two keyframes
+     */
+    XvidSegmentEncoder(int width, int height, int framerate, int maxKeyInterval);
+
+    /**
+     * Destroys the XviD encoder instance
+     */
+    ~XvidSegmentEncoder();
+
+    /**
+     * Encodes an I420 frame
+     * @param i420 Y, U and V planes of the frame, one after the other
+     * @param packet receives the compressed frame
+     * @param isKeyframe set to true if the compressed frame is a keyframe
+     */
+    void encode(const unsigned char* i420, std::vector<unsigned char>& packet, bool& isKeyframe);
+
+private:
+
+    XvidSegmentEncoder(const XvidSegmentEncoder&) = delete;
+    XvidSegmentEncoder& operator=(const XvidSegmentEncoder&) = delete;
+
+    static void initializeLibrary();
+
+    void* mHandle;
+    int mWidth;
+    int mHeight;
+    bool mIsFirstFrame;
+    std::vector<unsigned char> mBitstream;
+};
+
+#endif // XVIDSEGMENTENCODER_H
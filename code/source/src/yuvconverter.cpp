@@ -0,0 +1,330 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include "yuvconverter.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define YUV_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+// AVX2 is compiled with a function attribute and chosen at run-time, so that the default build
+// still runs on processors without AVX2
+#if defined(YUV_HAS_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define YUV_HAS_AVX2
+#include <immintrin.h>
+#endif
+
+// BT.601 limited range coefficients, scaled by 256
+static const int YR = 66, YG = 129, YB = 25;
+static const int UR = -38, UG = -74, UB = 112;
+static const int VR = 112, VG = -94, VB = -18;
+
+static inline unsigned char clampByte(int value)
+{
+    return (unsigned char)(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+static inline unsigned char computeLuma(int r, int g, int b)
+{
+    return clampByte(((YR * r + YG * g + YB * b + 128) >> 8) + 16);
+}
+
+#ifdef YUV_HAS_SSE2
+
+// Multiplies the low 16 bits of each 32-bit lane by a signed coefficient
+static inline __m128i coefficientSSE2(int coefficient)
+{
+    return _mm_set1_epi32(coefficient & 0xFFFF);
+}
+
+static inline __m128i weightSSE2(__m128i r, __m128i g, __m128i b, int cr, int cg, int cb)
+{
+    __m128i sum = _mm_madd_epi16(r, coefficientSSE2(cr));
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(g, coefficientSSE2(cg)));
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(b, coefficientSSE2(cb)));
+    return _mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(128)), 8);
+}
+
+// Sums the components of horizontal pixel pairs: [a0+a1, a2+a3, b0+b1, b2+b3]
+static inline __m128i pairSumSSE2(__m128i a, __m128i b)
+{
+    __m128 fa = _mm_castsi128_ps(a);
+    __m128 fb = _mm_castsi128_ps(b);
+    __m128i even = _mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(2, 0, 2, 0)));
+    __m128i odd = _mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(3, 1, 3, 1)));
+    return _mm_add_epi32(even, odd);
+}
+
+static int convertRowPairSSE2(const unsigned char* row0, const unsigned char* row1,
+                              unsigned char* y0, unsigned char* y1,
+                              unsigned char* u, unsigned char* v, int width)
+{
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    const __m128i lumaOffset = _mm_set1_epi32(16);
+    const __m128i chromaOffset = _mm_set1_epi32(128);
+    const __m128i two = _mm_set1_epi32(2);
+
+    int x = 0;
+    for(; x + 8 <= width; x += 8) {
+        // Four BGRA pixels per register, components are extracted in 32-bit lanes
+        __m128i p0a = _mm_loadu_si128((const __m128i*)(row0 + 4 * x));
+        __m128i p0b = _mm_loadu_si128((const __m128i*)(row0 + 4 * x + 16));
+        __m128i p1a = _mm_loadu_si128((const __m128i*)(row1 + 4 * x));
+        __m128i p1b = _mm_loadu_si128((const __m128i*)(row1 + 4 * x + 16));
+
+        __m128i b0a = _mm_and_si128(p0a, mask), g0a = _mm_and_si128(_mm_srli_epi32(p0a, 8), mask),
+                r0a = _mm_and_si128(_mm_srli_epi32(p0a, 16), mask);
+        __m128i b0b = _mm_and_si128(p0b, mask), g0b = _mm_and_si128(_mm_srli_epi32(p0b, 8), mask),
+                r0b = _mm_and_si128(_mm_srli_epi32(p0b, 16), mask);
+        __m128i b1a = _mm_and_si128(p1a, mask), g1a = _mm_and_si128(_mm_srli_epi32(p1a, 8), mask),
+                r1a = _mm_and_si128(_mm_srli_epi32(p1a, 16), mask);
+        __m128i b1b = _mm_and_si128(p1b, mask), g1b = _mm_and_si128(_mm_srli_epi32(p1b, 8), mask),
+                r1b = _mm_and_si128(_mm_srli_epi32(p1b, 16), mask);
+
+        // Luma of both rows
+        __m128i ya = _mm_add_epi32(weightSSE2(r0a, g0a, b0a, YR, YG, YB), lumaOffset);
+        __m128i yb = _mm_add_epi32(weightSSE2(r0b, g0b, b0b, YR, YG, YB), lumaOffset);
+        __m128i packed = _mm_packs_epi32(ya, yb);
+        _mm_storel_epi64((__m128i*)(y0 + x), _mm_packus_epi16(packed, packed));
+
+        ya = _mm_add_epi32(weightSSE2(r1a, g1a, b1a, YR, YG, YB), lumaOffset);
+        yb = _mm_add_epi32(weightSSE2(r1b, g1b, b1b, YR, YG, YB), lumaOffset);
+        packed = _mm_packs_epi32(ya, yb);
+        _mm_storel_epi64((__m128i*)(y1 + x), _mm_packus_epi16(packed, packed));
+
+        // Average of each 2x2 block for chroma
+        __m128i r = pairSumSSE2(_mm_add_epi32(r0a, r1a), _mm_add_epi32(r0b, r1b));
+        __m128i g = pairSumSSE2(_mm_add_epi32(g0a, g1a), _mm_add_epi32(g0b, g1b));
+        __m128i b = pairSumSSE2(_mm_add_epi32(b0a, b1a), _mm_add_epi32(b0b, b1b));
+        r = _mm_srli_epi32(_mm_add_epi32(r, two), 2);
+        g = _mm_srli_epi32(_mm_add_epi32(g, two), 2);
+        b = _mm_srli_epi32(_mm_add_epi32(b, two), 2);
+
+        __m128i cu = _mm_add_epi32(weightSSE2(r, g, b, UR, UG, UB), chromaOffset);
+        __m128i cv = _mm_add_epi32(weightSSE2(r, g, b, VR, VG, VB), chromaOffset);
+        packed = _mm_packs_epi32(cu, cv);
+        packed = _mm_packus_epi16(packed, packed);
+        int chroma = _mm_cvtsi128_si32(packed);
+        std::memcpy(u + x / 2, &chroma, 4);
+        chroma = _mm_cvtsi128_si32(_mm_srli_si128(packed, 4));
+        std::memcpy(v + x / 2, &chroma, 4);
+    }
+
+    return x;
+}
+
+#endif // YUV_HAS_SSE2
+
+#ifdef YUV_HAS_AVX2
+
+#define YUV_AVX2 __attribute__((target("avx2")))
+
+YUV_AVX2 static inline __m256i coefficientAVX2(int coefficient)
+{
+    return _mm256_set1_epi32(coefficient & 0xFFFF);
+}
+
+YUV_AVX2 static inline __m256i weightAVX2(__m256i r, __m256i g, __m256i b, int cr, int cg, int cb)
+{
+    __m256i sum = _mm256_madd_epi16(r, coefficientAVX2(cr));
+    sum = _mm256_add_epi32(sum, _mm256_madd_epi16(g, coefficientAVX2(cg)));
+    sum = _mm256_add_epi32(sum, _mm256_madd_epi16(b, coefficientAVX2(cb)));
+    return _mm256_srai_epi32(_mm256_add_epi32(sum, _mm256_set1_epi32(128)), 8);
+}
+
+// Packs eight 32-bit lanes to eight 16-bit values, keeping their order across 128-bit lanes
+YUV_AVX2 static inline __m128i narrowAVX2(__m256i values)
+{
+    return _mm_packs_epi32(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+}
+
+YUV_AVX2 static int convertRowPairAVX2(const unsigned char* row0, const unsigned char* row1,
+                                       unsigned char* y0, unsigned char* y1,
+                                       unsigned char* u, unsigned char* v, int width)
+{
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    const __m256i lumaOffset = _mm256_set1_epi32(16);
+    const __m256i chromaOffset = _mm256_set1_epi32(128);
+    const __m256i two = _mm256_set1_epi32(2);
+    // Pair sums come out as chroma samples 0 1 4 5 2 3 6 7 because shuffles work per 128-bit lane
+    const __m256i chromaOrder = _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7);
+
+    int x = 0;
+    for(; x + 16 <= width; x += 16) {
+        __m256i p0a = _mm256_loadu_si256((const __m256i*)(row0 + 4 * x));
+        __m256i p0b = _mm256_loadu_si256((const __m256i*)(row0 + 4 * x + 32));
+        __m256i p1a = _mm256_loadu_si256((const __m256i*)(row1 + 4 * x));
+        __m256i p1b = _mm256_loadu_si256((const __m256i*)(row1 + 4 * x + 32));
+
+        __m256i b0a = _mm256_and_si256(p0a, mask), g0a = _mm256_and_si256(_mm256_srli_epi32(p0a, 8), mask),
+                r0a = _mm256_and_si256(_mm256_srli_epi32(p0a, 16), mask);
+        __m256i b0b = _mm256_and_si256(p0b, mask), g0b = _mm256_and_si256(_mm256_srli_epi32(p0b, 8), mask),
+                r0b = _mm256_and_si256(_mm256_srli_epi32(p0b, 16), mask);
+        __m256i b1a = _mm256_and_si256(p1a, mask), g1a = _mm256_and_si256(_mm256_srli_epi32(p1a, 8), mask),
+                r1a = _mm256_and_si256(_mm256_srli_epi32(p1a, 16), mask);
+        __m256i b1b = _mm256_and_si256(p1b, mask), g1b = _mm256_and_si256(_mm256_srli_epi32(p1b, 8), mask),
+                r1b = _mm256_and_si256(_mm256_srli_epi32(p1b, 16), mask);
+
+        __m128i ya = narrowAVX2(_mm256_add_epi32(weightAVX2(r0a, g0a, b0a, YR, YG, YB), lumaOffset));
+        __m128i yb = narrowAVX2(_mm256_add_epi32(weightAVX2(r0b, g0b, b0b, YR, YG, YB), lumaOffset));
+        _mm_storeu_si128((__m128i*)(y0 + x), _mm_packus_epi16(ya, yb));
+
+        ya = narrowAVX2(_mm256_add_epi32(weightAVX2(r1a, g1a, b1a, YR, YG, YB), lumaOffset));
+        yb = narrowAVX2(_mm256_add_epi32(weightAVX2(r1b, g1b, b1b, YR, YG, YB), lumaOffset));
+        _mm_storeu_si128((__m128i*)(y1 + x), _mm_packus_epi16(ya, yb));
+
+        __m256 fa, fb;
+        __m256i sa, sb;
+
+        sa = _mm256_add_epi32(r0a, r1a); sb = _mm256_add_epi32(r0b, r1b);
+        fa = _mm256_castsi256_ps(sa); fb = _mm256_castsi256_ps(sb);
+        __m256i r = _mm256_add_epi32(_mm256_castps_si256(_mm256_shuffle_ps(fa, fb, _MM_SHUFFLE(2, 0, 2, 0))),
+                                     _mm256_castps_si256(_mm256_shuffle_ps(fa, fb, _MM_SHUFFLE(3, 1, 3, 1))));
+        sa = _mm256_add_epi32(g0a, g1a); sb = _mm256_add_epi32(g0b, g1b);
+        fa = _mm256_castsi256_ps(sa); fb = _mm256_castsi256_ps(sb);
+        __m256i g = _mm256_add_epi32(_mm256_castps_si256(_mm256_shuffle_ps(fa, fb, _MM_SHUFFLE(2, 0, 2, 0))),
+                                     _mm256_castps_si256(_mm256_shuffle_ps(fa, fb, _MM_SHUFFLE(3, 1, 3, 1))));
+        sa = _mm256_add_epi32(b0a, b1a); sb = _mm256_add_epi32(b0b, b1b);
+        fa = _mm256_castsi256_ps(sa); fb = _mm256_castsi256_ps(sb);
+        __m256i b = _mm256_add_epi32(_mm256_castps_si256(_mm256_shuffle_ps(fa, fb, _MM_SHUFFLE(2, 0, 2, 0))),
+                                     _mm256_castps_si256(_mm256_shuffle_ps(fa, fb, _MM_SHUFFLE(3, 1, 3, 1))));
+
+        r = _mm256_srli_epi32(_mm256_add_epi32(r, two), 2);
+        g = _mm256_srli_epi32(_mm256_add_epi32(g, two), 2);
+        b = _mm256_srli_epi32(_mm256_add_epi32(b, two), 2);
+
+        __m256i cu = _mm256_add_epi32(weightAVX2(r, g, b, UR, UG, UB), chromaOffset);
+        __m256i cv = _mm256_add_epi32(weightAVX2(r, g, b, VR, VG, VB), chromaOffset);
+        __m128i packedU = narrowAVX2(_mm256_permutevar8x32_epi32(cu, chromaOrder));
+        __m128i packedV = narrowAVX2(_mm256_permutevar8x32_epi32(cv, chromaOrder));
+        __m128i packed = _mm_packus_epi16(packedU, packedV);
+        _mm_storel_epi64((__m128i*)(u + x / 2), packed);
+        _mm_storel_epi64((__m128i*)(v + x / 2), _mm_srli_si128(packed, 8));
+    }
+
+    return x;
+}
+
+#endif // YUV_HAS_AVX2
+
+YuvConverter::YuvConverter(int width, int height)
+{
+    mWidth = width;
+    mHeight = height;
+    mChromaWidth = (width + 1) / 2;
+    mChromaHeight = (height + 1) / 2;
+    mData.resize(mWidth * mHeight + 2 * mChromaWidth * mChromaHeight);
+}
+
+YuvConverter::RowPairKernel YuvConverter::selectKernel()
+{
+#ifdef YUV_HAS_AVX2
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) {
+        return &convertRowPairAVX2;
+    }
+#endif
+#ifdef YUV_HAS_SSE2
+    return &convertRowPairSSE2;
+#else
+    return nullptr;
+#endif
+}
+
+const char* YuvConverter::getKernelName()
+{
+    RowPairKernel kernel = selectKernel();
+#ifdef YUV_HAS_AVX2
+    if(kernel == &convertRowPairAVX2) {
+        return "avx2";
+    }
+#endif
+    return kernel != nullptr ? "sse2" : "scalar";
+}
+
+void YuvConverter::convert(const unsigned char* bgra, int pitch)
+{
+    // Kernel is chosen once for the whole program
+    static const RowPairKernel kernel = selectKernel();
+
+    unsigned char* yPlane = mData.data();
+    unsigned char* uPlane = yPlane + mWidth * mHeight;
+    unsigned char* vPlane = uPlane + mChromaWidth * mChromaHeight;
+
+    for(int row = 0; row < mHeight; row += 2) {
+        // An odd last row is paired with itself
+        bool hasSecondRow = row + 1 < mHeight;
+        const unsigned char* row0 = bgra + row * pitch;
+        const unsigned char* row1 = hasSecondRow ? row0 + pitch : row0;
+        unsigned char* y0 = yPlane + row * mWidth;
+        unsigned char* y1 = hasSecondRow ? y0 + mWidth : y0;
+        unsigned char* u = uPlane + (row / 2) * mChromaWidth;
+        unsigned char* v = vPlane + (row / 2) * mChromaWidth;
+
+        int converted = kernel != nullptr ? kernel(row0, row1, y0, y1, u, v, mWidth) : 0;
+        convertRowPairScalar(row0, row1, y0, y1, u, v, converted, mWidth);
+    }
+}
+
+void YuvConverter::convertRowPairScalar(const unsigned char* row0, const unsigned char* row1,
+                                        unsigned char* y0, unsigned char* y1,
+                                        unsigned char* u, unsigned char* v, int begin, int width)
+{
+    for(int x = begin; x < width; x += 2) {
+        // An odd last column is paired with itself
+        int next = x + 1 < width ? x + 1 : x;
+        const unsigned char* p00 = row0 + 4 * x;
+        const unsigned char* p01 = row0 + 4 * next;
+        const unsigned char* p10 = row1 + 4 * x;
+        const unsigned char* p11 = row1 + 4 * next;
+
+        // Memory order is B, G, R, A
+        y0[x] = computeLuma(p00[2], p00[1], p00[0]);
+        y0[next] = computeLuma(p01[2], p01[1], p01[0]);
+        y1[x] = computeLuma(p10[2], p10[1], p10[0]);
+        y1[next] = computeLuma(p11[2], p11[1], p11[0]);
+
+        int r = (p00[2] + p01[2] + p10[2] + p11[2] + 2) >> 2;
+        int g = (p00[1] + p01[1] + p10[1] + p11[1] + 2) >> 2;
+        int b = (p00[0] + p01[0] + p10[0] + p11[0] + 2) >> 2;
+        u[x / 2] = clampByte(((UR * r + UG * g + UB * b + 128) >> 8) + 128);
+        v[x / 2] = clampByte(((VR * r + VG * g + VB * b + 128) >> 8) + 128);
+    }
+}
+
+const unsigned char* YuvConverter::getData() const
+{
+    return mData.data();
+}
+
+int YuvConverter::getDataSize() const
+{
+    return (int) mData.size();
+}
+
+int YuvConverter::getWidth() const
+{
+    return mWidth;
+}
+
+int YuvConverter::getHeight() const
+{
+    return mHeight;
+}
@@ -0,0 +1,105 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YUVCONVERTER_H
+#define YUVCONVERTER_H
+
+#include <vector>
+
+/**
+ * @brief Converts BGRA screenshots to planar YUV 4:2:0 (I420)
+ *
+ * Holds a preallocated I420 frame (Y plane, then U plane, then V plane) which is overwritten by each call
+ * to convert(). The conversion uses BT.601 limited range coefficients, and chroma is the average of each
+ * 2x2 pixel block. An AVX2 or SSE2 kernel is used when the processor supports it, with a scalar fallback
+ * for other processors and for the right and bottom borders.
+ */
+class YuvConverter
+{
+
+public:
+
+    /**
+     * Allocates the planes for frames of the given size
+     * @param width frame width in pixels
+     * @param height frame height in pixels
+     */
+    YuvConverter(int width, int height);
+
+    /**
+     * Converts a BGRA image (Irrlicht A8R8G8B8 in memory) into the I420 planes
+     * @param bgra first pixel of the source image
+     * @param pitch size of a source row in bytes
+     */
+    void convert(const unsigned char* bgra, int pitch);
+
+    /**
+     * Returns the I420 frame, made of the Y, U and V planes one after the other
+     * @return frame data
+     */
+    const unsigned char* getData() const;
+
+    /**
+     * Returns size of the I420 frame
+     * @return size in bytes
+     */
+    int getDataSize() const;
+
+    /**
+     * Returns frame width
+     * @return width in pixels
+     */
+    int getWidth() const;
+
+    /**
+     * Returns frame height
+     * @return height in pixels
+     */
+    int getHeight() const;
+
+    /**
+     * Returns the name of the kernel chosen for this processor ("avx2", "sse2" or "scalar")
+     * @return kernel name
+     */
+    static const char* getKernelName();
+
+private:
+
+    /**
+     * Signature of the kernels converting a pair of rows. A kernel converts as many pixels as it can
+     * process in full vectors and returns this number, so that the caller finishes the row.
+     */
+    typedef int (*RowPairKernel)(const unsigned char* row0, const unsigned char* row1,
+                                 unsigned char* y0, unsigned char* y1,
+                                 unsigned char* u, unsigned char* v, int width);
+
+    static RowPairKernel selectKernel();
+
+    static void convertRowPairScalar(const unsigned char* row0, const unsigned char* row1,
+                                     unsigned char* y0, unsigned char* y1,
+                                     unsigned char* u, unsigned char* v, int begin, int width);
+
+    int mWidth;
+    int mHeight;
+    int mChromaWidth;
+    int mChromaHeight;
+
+    std::vector<unsigned char> mData;
+};
+
+#endif // YUVCONVERTER_H
@@ -0,0 +1,44 @@
+#/*
+# *  Copyright 2014 Pierre Walch
+# *  Website : www.pwalch.net
+# *
+# *  Avatars is free software: you can redistribute it and/or modify
+# *  it under the terms of the GNU General Public License as published by
+# *  the Free Software Foundation, either version 3 of the License, or
+# *  (at your option) any later version.
+
+# *  Avatars is distributed in the hope that it will be useful,
+# *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+# *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# *  GNU General Public License for more details.
+
+# *  You should have received a copy of the GNU General Public License
+# *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+# */
+
+# Generator of synthetic matches, built without Qt
+CONFIG += console c++11
+CONFIG -= qt app_bundle
+
+QMAKE_CXXFLAGS += -Werror "-Wno-unused-parameter"
+
+TARGET = MatchGen
+TEMPLATE = app
+
+INCLUDEPATH += ../..
+
+# TinyXML-2 is configured with the Irrlicht types, only its headers are needed
+win32 {
+    INCLUDEPATH += C:\Irrlicht\irrlicht-1.7.1\include
+}
+
+unix {
+    INCLUDEPATH += /usr/include/irrlicht
+}
+
+SOURCES += main.cpp \
+    matchgenerator.cpp \
+    ../../libs/tinyxml2.cpp
+
+HEADERS += matchgenerator.h \
+    ../../libs/tinyxml2.h
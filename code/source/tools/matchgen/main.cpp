@@ -0,0 +1,167 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include "libs/tinyxml2.h"
+#include "matchgenerator.h"
+
+using namespace tinyxml2;
+
+namespace
+{
+    void printUsage(const char* program)
+    {
+        std::cerr << "Usage: " << program << " [options] prefix" << std::endl
+                  << "Writes prefix_players.txt, prefix_ball.txt, prefix_camera.txt and prefix_jerseys.txt" << std::endl
+                  << "  --players N      number of players (22)" << std::endl
+                  << "  --frames N       number of frames (2250)" << std::endl
+                  << "  --framerate N    frame rate (25)" << std::endl
+                  << "  --gaps P         probability for a player to be lost at each frame (0.002)" << std::endl
+                  << "  --maxgap N       maximum length of a gap in frames (50)" << std::endl
+                  << "  --seed N         seed of the random generator (1)" << std::endl
+                  << "  --config FILE    configuration to copy into prefix_config.xml, using the generated" << std::endl
+                  << "                   files and the benchmark mode; its team IDs are used for the jerseys" << std::endl;
+    }
+
+    bool open(std::ofstream& file, const std::string& fileName)
+    {
+        file.open(fileName.c_str());
+        if(!file.is_open()) {
+            std::cerr << "File cannot be created: " << fileName << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Returns a child element found by a path of tag names, or nullptr
+     */
+    XMLElement* findElement(XMLDocument& doc, const char* parent, const char* child)
+    {
+        auto root = doc.FirstChildElement("avatarsConfig");
+        if(root == nullptr || root->FirstChildElement(parent) == nullptr)
+            return nullptr;
+        return root->FirstChildElement(parent)->FirstChildElement(child);
+    }
+}
+
+/**
+ * Generates the tracking files of a synthetic match, and optionally a configuration running the benchmark
+ * mode on them
+ */
+int main(int argc, char* argv[])
+{
+    MatchSettings settings;
+    std::string configName;
+    std::string prefix;
+    for(int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if(strcmp(argv[i], "--players") == 0 && hasValue) {
+            settings.mNbPlayers = atoi(argv[++i]);
+        } else if(strcmp(argv[i], "--frames") == 0 && hasValue) {
+            settings.mNbFrames = atoi(argv[++i]);
+        } else if(strcmp(argv[i], "--framerate") == 0 && hasValue) {
+            settings.mFramerate = atoi(argv[++i]);
+        } else if(strcmp(argv[i], "--gaps") == 0 && hasValue) {
+            settings.mGapProbability = (float) atof(argv[++i]);
+        } else if(strcmp(argv[i], "--maxgap") == 0 && hasValue) {
+            settings.mMaxGapLength = atoi(argv[++i]);
+        } else if(strcmp(argv[i], "--seed") == 0 && hasValue) {
+            settings.mSeed = (unsigned int) atol(argv[++i]);
+        } else if(strcmp(argv[i], "--config") == 0 && hasValue) {
+            configName = argv[++i];
+        } else if(argv[i][0] != '-' && prefix.empty()) {
+            prefix = argv[i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if(prefix.empty() || settings.mNbPlayers < 1 || settings.mNbFrames < 1 || settings.mFramerate < 1) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Jerseys must use the team IDs of the configuration
+    XMLDocument config;
+    if(!configName.empty()) {
+        if(config.LoadFile(configName.c_str()) != XML_NO_ERROR) {
+            std::cerr << "Configuration cannot be loaded: " << configName << std::endl;
+            return 1;
+        }
+        auto teams = findElement(config, "input", "teams");
+        if(teams == nullptr
+                || teams->QueryIntAttribute("redNormal", &settings.mRedNormal) != XML_NO_ERROR
+                || teams->QueryIntAttribute("blueNormal", &settings.mBlueNormal) != XML_NO_ERROR
+                || teams->QueryIntAttribute("redSpecial", &settings.mRedSpecial) != XML_NO_ERROR
+                || teams->QueryIntAttribute("blueSpecial", &settings.mBlueSpecial) != XML_NO_ERROR) {
+            std::cerr << "Configuration has no team IDs: " << configName << std::endl;
+            return 1;
+        }
+    }
+
+    std::string playerName = prefix + "_players.txt";
+    std::string ballName = prefix + "_ball.txt";
+    std::string cameraName = prefix + "_camera.txt";
+    std::string jerseyName = prefix + "_jerseys.txt";
+    std::ofstream playerFile, ballFile, cameraFile, jerseyFile;
+    if(!open(playerFile, playerName) || !open(ballFile, ballName) || !open(cameraFile, cameraName)
+            || !open(jerseyFile, jerseyName))
+        return 1;
+
+    MatchGenerator generator(settings);
+    generator.generate(playerFile, ballFile, cameraFile, jerseyFile);
+    if(!playerFile.good() || !ballFile.good() || !cameraFile.good() || !jerseyFile.good()) {
+        std::cerr << "Trajectories could not be written" << std::endl;
+        return 1;
+    }
+
+    if(!configName.empty()) {
+        auto mode = findElement(config, "graphics", "mode");
+        auto image = findElement(config, "input", "image");
+        auto tracking = findElement(config, "input", "tracking");
+        auto camera = findElement(config, "output", "camera");
+        auto sequence = findElement(config, "output", "sequence");
+        if(mode == nullptr || image == nullptr || tracking == nullptr || camera == nullptr || sequence == nullptr) {
+            std::cerr << "Configuration is incomplete: " << configName << std::endl;
+            return 1;
+        }
+
+        mode->SetAttribute("type", 3);
+        image->SetAttribute("frameNumber", settings.mNbFrames);
+        image->SetAttribute("frameRate", settings.mFramerate);
+        image->SetAttribute("current", 0);
+        tracking->SetAttribute("players", playerName.c_str());
+        tracking->SetAttribute("ball", ballName.c_str());
+        tracking->SetAttribute("jerseys", jerseyName.c_str());
+        camera->SetAttribute("trajectory", cameraName.c_str());
+        sequence->SetAttribute("start", 0);
+        sequence->SetAttribute("end", settings.mNbFrames - 1);
+
+        std::string outputConfigName = prefix + "_config.xml";
+        if(config.SaveFile(outputConfigName.c_str()) != XML_NO_ERROR) {
+            std::cerr << "Configuration cannot be written: " << outputConfigName << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
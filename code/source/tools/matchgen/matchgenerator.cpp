@@ -0,0 +1,254 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+#include "matchgenerator.h"
+
+namespace
+{
+    const float pi = 3.14159265f;
+
+    // Speeds in millimeters per second, accelerations in millimeters per square second
+    const float walkSpeed = 1500;
+    const float jogSpeed = 4000;
+    const float sprintSpeed = 7000;
+    const float maxAcceleration = 4000;
+    const float passSpeed = 15000;
+    const float ballRadius = 110;
+
+    // Camera stands behind the touchline at Y = 0
+    const float cameraDistance = 25000;
+    const float cameraHeight = 15000;
+}
+
+MatchGenerator::MatchGenerator(const MatchSettings& settings)
+    : mSettings(settings), mRandom(settings.mSeed)
+{
+}
+
+void MatchGenerator::generate(std::ostream& playerOut, std::ostream& ballOut, std::ostream& cameraOut,
+                              std::ostream& jerseyOut)
+{
+    placePlayers();
+
+    // First player of each team is its goalkeeper
+    int teamSize = (mSettings.mNbPlayers + 1) / 2;
+    for(int i = 0; i < mSettings.mNbPlayers; ++i) {
+        bool isRed = i < teamSize;
+        int rank = isRed ? i : i - teamSize;
+        int team = isRed ? (rank == 0 ? mSettings.mRedSpecial : mSettings.mRedNormal)
+                         : (rank == 0 ? mSettings.mBlueSpecial : mSettings.mBlueNormal);
+        jerseyOut << i << " " << team << " " << rank + 1 << "\n";
+    }
+
+    mOwner = mSettings.mNbPlayers > 1 ? 1 : 0;
+    mReceiver = mOwner;
+    mFlightFrames = 0;
+    mFlightLength = 0;
+    mHoldFrames = mSettings.mFramerate;
+    mBallX = mPlayers[mOwner].mX;
+    mBallY = mPlayers[mOwner].mY;
+    mBallZ = ballRadius;
+    mCameraTargetX = mBallX;
+    mCameraTargetY = mBallY;
+
+    playerOut << std::fixed << std::setprecision(1);
+    ballOut << std::fixed << std::setprecision(1);
+    cameraOut << std::fixed << std::setprecision(2);
+
+    std::uniform_real_distribution<float> uniform(0.f, 1.f);
+    std::uniform_int_distribution<int> gapLength(1, std::max(1, mSettings.mMaxGapLength));
+    for(int frame = 0; frame < mSettings.mNbFrames; ++frame) {
+        for(unsigned int i = 0; i < mPlayers.size(); ++i) {
+            auto& player = mPlayers[i];
+            movePlayer(player, mBallX, mBallY);
+
+            // The first frame is always tracked, so that every player has a position to hold
+            if(player.mGapFrames > 0) {
+                --player.mGapFrames;
+            } else if(frame > 0 && uniform(mRandom) < mSettings.mGapProbability) {
+                player.mGapFrames = gapLength(mRandom) - 1;
+            } else {
+                playerOut << frame << " " << i << " " << player.mX << " " << player.mY << "\n";
+            }
+        }
+
+        moveBall();
+        ballOut << frame << " " << mBallX << " " << mBallY << " " << mBallZ << "\n";
+
+        moveCamera();
+        float cameraX = mSettings.mPitchLength / 2 + (mCameraTargetX - mSettings.mPitchLength / 2) * 0.6f;
+        float dx = mCameraTargetX - cameraX;
+        float dy = mCameraTargetY + cameraDistance;
+        float yaw = atan2f(-dx, dy) * 180 / pi;
+        float pitch = atan2f(cameraHeight, sqrtf(dx * dx + dy * dy)) * 180 / pi;
+        cameraOut << frame << " " << cameraX << " " << -cameraDistance << " " << cameraHeight << " "
+                  << pitch << " " << yaw << " " << 0.f << "\n";
+    }
+}
+
+void MatchGenerator::placePlayers()
+{
+    // Each team spreads on a grid of its half, goalkeeper in front of its goal
+    int teamSize = (mSettings.mNbPlayers + 1) / 2;
+    mPlayers.clear();
+    for(int i = 0; i < mSettings.mNbPlayers; ++i) {
+        bool isRed = i < teamSize;
+        int rank = isRed ? i : i - teamSize;
+
+        float depth, side;
+        if(rank == 0) {
+            depth = 0.05f;
+            side = 0.5f;
+        } else {
+            int nbLines = 3;
+            int line = (rank - 1) % nbLines;
+            int nbInLine = (teamSize - 1 + nbLines - 1) / nbLines;
+            int place = (rank - 1) / nbLines;
+            depth = 0.15f + 0.12f * line;
+            side = (place + 0.5f) / std::max(1, nbInLine);
+        }
+
+        Body player;
+        player.mHomeX = (isRed ? depth : 1 - depth) * mSettings.mPitchLength;
+        player.mHomeY = side * mSettings.mPitchWidth;
+        player.mX = player.mHomeX;
+        player.mY = player.mHomeY;
+        player.mSpeedX = 0;
+        player.mSpeedY = 0;
+        player.mTargetX = player.mX;
+        player.mTargetY = player.mY;
+        player.mTargetSpeed = 0;
+        player.mTargetFrames = 0;
+        player.mGapFrames = 0;
+        mPlayers.push_back(player);
+    }
+}
+
+void MatchGenerator::movePlayer(Body& player, float ballX, float ballY)
+{
+    float dt = 1.f / mSettings.mFramerate;
+
+    // A new target is chosen around the formation position, which follows the ball
+    if(--player.mTargetFrames <= 0) {
+        float shift = (ballX - mSettings.mPitchLength / 2) * 0.5f;
+        player.mTargetX = std::min(std::max(player.mHomeX + shift + getRandom(-10000, 10000), 0.f),
+                                   mSettings.mPitchLength);
+        player.mTargetY = std::min(std::max(player.mHomeY + (ballY - player.mHomeY) * 0.2f
+                                            + getRandom(-8000, 8000), 0.f), mSettings.mPitchWidth);
+
+        float gait = getRandom(0, 1);
+        player.mTargetSpeed = gait < 0.5f ? walkSpeed : (gait < 0.85f ? jogSpeed : sprintSpeed);
+        player.mTargetFrames = (int) (getRandom(1, 4) * mSettings.mFramerate);
+    }
+
+    // Speed goes towards the target, slowing down on arrival, with bounded acceleration
+    float toTargetX = player.mTargetX - player.mX;
+    float toTargetY = player.mTargetY - player.mY;
+    float distance = sqrtf(toTargetX * toTargetX + toTargetY * toTargetY);
+    float wantedSpeed = std::min(player.mTargetSpeed, 2 * distance);
+    float wantedX = distance > 0 ? toTargetX / distance * wantedSpeed : 0;
+    float wantedY = distance > 0 ? toTargetY / distance * wantedSpeed : 0;
+
+    float changeX = wantedX - player.mSpeedX;
+    float changeY = wantedY - player.mSpeedY;
+    float change = sqrtf(changeX * changeX + changeY * changeY);
+    float maxChange = maxAcceleration * dt;
+    if(change > maxChange) {
+        changeX *= maxChange / change;
+        changeY *= maxChange / change;
+    }
+
+    player.mSpeedX += changeX;
+    player.mSpeedY += changeY;
+    player.mX += player.mSpeedX * dt;
+    player.mY += player.mSpeedY * dt;
+}
+
+void MatchGenerator::moveBall()
+{
+    if(mFlightFrames < mFlightLength) {
+        // Ball flies to the current position of the receiver
+        ++mFlightFrames;
+        float t = (float) mFlightFrames / mFlightLength;
+        auto& receiver = mPlayers[mReceiver];
+        mBallX = mFlightStartX + (receiver.mX - mFlightStartX) * t;
+        mBallY = mFlightStartY + (receiver.mY - mFlightStartY) * t;
+        mBallZ = ballRadius + 4 * mFlightHeight * t * (1 - t);
+
+        if(mFlightFrames == mFlightLength) {
+            mOwner = mReceiver;
+            mHoldFrames = (int) (getRandom(0.5f, 3) * mSettings.mFramerate);
+        }
+        return;
+    }
+
+    // Ball is kept slightly ahead of its owner
+    auto& owner = mPlayers[mOwner];
+    float speed = sqrtf(owner.mSpeedX * owner.mSpeedX + owner.mSpeedY * owner.mSpeedY);
+    mBallX = owner.mX + (speed > 0 ? owner.mSpeedX / speed * 300 : 0);
+    mBallY = owner.mY + (speed > 0 ? owner.mSpeedY / speed * 300 : 0);
+    mBallZ = ballRadius;
+
+    if(--mHoldFrames <= 0 && mPlayers.size() > 1)
+        startPass();
+}
+
+void MatchGenerator::startPass()
+{
+    // Most passes go to a teammate
+    int teamSize = (mSettings.mNbPlayers + 1) / 2;
+    bool isRedOwner = mOwner < teamSize;
+    bool toTeammate = getRandom(0, 1) < 0.8f;
+    bool isRedReceiver = toTeammate ? isRedOwner : !isRedOwner;
+
+    int first = isRedReceiver ? 0 : teamSize;
+    int last = isRedReceiver ? teamSize - 1 : mSettings.mNbPlayers - 1;
+    if(last < first)
+        return;
+    std::uniform_int_distribution<int> pick(first, last);
+    do {
+        mReceiver = pick(mRandom);
+    } while(mReceiver == mOwner && last > first);
+
+    mFlightStartX = mBallX;
+    mFlightStartY = mBallY;
+    float dx = mPlayers[mReceiver].mX - mBallX;
+    float dy = mPlayers[mReceiver].mY - mBallY;
+    float distance = sqrtf(dx * dx + dy * dy);
+
+    // Long passes are lofted
+    mFlightHeight = distance > 25000 ? getRandom(2000, 8000) : 0;
+    mFlightLength = std::max(1, (int) (distance / passSpeed * mSettings.mFramerate));
+    mFlightFrames = 0;
+}
+
+void MatchGenerator::moveCamera()
+{
+    // Camera operator follows the ball smoothly
+    mCameraTargetX += (mBallX - mCameraTargetX) * 0.05f;
+    mCameraTargetY += (mBallY - mCameraTargetY) * 0.05f;
+}
+
+float MatchGenerator::getRandom(float min, float max)
+{
+    std::uniform_real_distribution<float> distribution(min, max);
+    return distribution(mRandom);
+}
@@ -0,0 +1,176 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATCHGENERATOR_H
+#define MATCHGENERATOR_H
+
+#include <string>
+#include <vector>
+#include <random>
+#include <ostream>
+
+/**
+ * @brief Settings of a synthetic match
+ *
+ * Distances are in millimeters, like the tracking files, on a pitch whose corner is the origin.
+ */
+class MatchSettings
+{
+public:
+    /**
+     * Creates the settings of a 90 second match between two teams of 11 players
+     */
+    MatchSettings() {
+        mNbPlayers = 22;
+        mNbFrames = 2250;
+        mFramerate = 25;
+        mGapProbability = 0.002f;
+        mMaxGapLength = 50;
+        mSeed = 1;
+        mPitchLength = 105000;
+        mPitchWidth = 68000;
+        mRedNormal = 0;
+        mBlueNormal = 1;
+        mRedSpecial = 2;
+        mBlueSpecial = 3;
+    }
+
+    /**
+     * Number of players, split in two teams whose first player is the goalkeeper
+     */
+    int mNbPlayers;
+
+    /**
+     * Number of frames of each trajectory
+     */
+    int mNbFrames;
+
+    /**
+     * Frame rate of the trajectories
+     */
+    int mFramerate;
+
+    /**
+     * Probability for a tracked body to be lost at each frame, the ball and the camera being never lost
+     */
+    float mGapProbability;
+
+    /**
+     * Maximum number of frames of a gap in the trajectory of a player
+     */
+    int mMaxGapLength;
+
+    /**
+     * Seed of the random generator, so that a match can be generated again
+     */
+    unsigned int mSeed;
+
+    /**
+     * Length of the pitch, along X
+     */
+    float mPitchLength;
+
+    /**
+     * Width of the pitch, along Y
+     */
+    float mPitchWidth;
+
+    /**
+     * Team IDs of the jersey file: field players, then goalkeepers, of each team
+     */
+    int mRedNormal;
+    int mBlueNormal;
+    int mRedSpecial;
+    int mBlueSpecial;
+};
+
+/**
+ * @brief Generates the tracking files of a synthetic match
+ *
+ * Players run between random targets around their position in a formation which follows the ball, with
+ * bounded speed and acceleration. The ball is kept by a player, then passed to another one, with a lofted
+ * trajectory for long passes. The camera follows the ball from behind a touchline. Players may be lost by
+ * the tracker for a few frames, in which case their lines are missing from the player file.
+ */
+class MatchGenerator
+{
+
+public:
+
+    /**
+     * Creates a generator
+     * @param settings settings of the match
+     */
+    explicit MatchGenerator(const MatchSettings& settings);
+
+    /**
+     * Generates the match and writes the player, ball, camera and jersey files
+     * @param playerOut player trajectories: "frame player x y"
+     * @param ballOut ball trajectory: "frame x y z"
+     * @param cameraOut camera trajectory: "frame x y z pitch yaw roll"
+     * @param jerseyOut jersey file: "player team number"
+     */
+    void generate(std::ostream& playerOut, std::ostream& ballOut, std::ostream& cameraOut, std::ostream& jerseyOut);
+
+private:
+
+    struct Body
+    {
+        float mX;
+        float mY;
+        float mSpeedX;
+        float mSpeedY;
+        float mHomeX;
+        float mHomeY;
+        float mTargetX;
+        float mTargetY;
+        float mTargetSpeed;
+        int mTargetFrames;
+        int mGapFrames;
+    };
+
+    void placePlayers();
+    void movePlayer(Body& player, float ballX, float ballY);
+    void moveBall();
+    void startPass();
+    void moveCamera();
+    float getRandom(float min, float max);
+
+    MatchSettings mSettings;
+    std::mt19937 mRandom;
+    std::vector<Body> mPlayers;
+
+    // Ball is either at the feet of its owner, or flying from a start point to its receiver
+    int mOwner;
+    int mReceiver;
+    int mFlightFrames;
+    int mFlightLength;
+    int mHoldFrames;
+    float mBallX;
+    float mBallY;
+    float mBallZ;
+    float mFlightStartX;
+    float mFlightStartY;
+    float mFlightHeight;
+
+    // Camera looks at a smoothed ball position
+    float mCameraTargetX;
+    float mCameraTargetY;
+};
+
+#endif // MATCHGENERATOR_H
@@ -0,0 +1,50 @@
+#/*
+# *  Copyright 2014 Pierre Walch
+# *  Website : www.pwalch.net
+# *
+# *  Avatars is free software: you can redistribute it and/or modify
+# *  it under the terms of the GNU General Public License as published by
+# *  the Free Software Foundation, either version 3 of the License, or
+# *  (at your option) any later version.
+
+# *  Avatars is distributed in the hope that it will be useful,
+# *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+# *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# *  GNU General Public License for more details.
+
+# *  You should have received a copy of the GNU General Public License
+# *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+# */
+
+# Trajectory toolkit, built without Qt
+CONFIG += console c++11
+CONFIG -= qt app_bundle
+
+QMAKE_CXXFLAGS += -Werror "-Wno-unused-parameter"
+
+TARGET = TrajTool
+TEMPLATE = app
+
+INCLUDEPATH += ../.. ../../src
+
+# Only the Irrlicht headers are needed, for the vector types
+win32 {
+    INCLUDEPATH += C:\Irrlicht\irrlicht-1.7.1\include
+}
+
+unix {
+    INCLUDEPATH += /usr/include/irrlicht
+}
+
+SOURCES += main.cpp \
+    trajectorytransform.cpp \
+    camerapathgenerator.cpp \
+    ../../src/trajectoryparser.cpp \
+    ../../src/trajectorywriter.cpp \
+    ../../src/science.cpp
+
+HEADERS += trajectorytransform.h \
+    camerapathgenerator.h \
+    ../../src/trajectoryparser.h \
+    ../../src/trajectorywriter.h \
+    ../../src/science.h
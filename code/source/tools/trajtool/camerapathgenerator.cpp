@@ -0,0 +1,78 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include "trajectorywriter.h"
+#include "camerapathgenerator.h"
+
+CameraPathGenerator::CameraPathGenerator(const CameraPathSettings& settings)
+{
+    mSettings = settings;
+}
+
+int CameraPathGenerator::generate(std::ostream& out) const
+{
+    int lastFrame = mSettings.mNbFrames - 1;
+    int step = mSettings.mKeyframeInterval > 0 ? mSettings.mKeyframeInterval : 1;
+
+    int nbLines = 0;
+    int frame = 0;
+    while(frame <= lastFrame) {
+        vector3df position, rotation;
+        getPose(frame, position, rotation);
+        TrajectoryWriter::writeCameraLine(out, frame, position, rotation);
+        ++nbLines;
+
+        // Keyframed paths always end with the last frame, so that the camera reaches the end of the move
+        if(frame < lastFrame && frame + step > lastFrame)
+            frame = lastFrame;
+        else
+            frame += step;
+    }
+
+    return nbLines;
+}
+
+void CameraPathGenerator::getPose(int frame, vector3df& position, vector3df& rotation) const
+{
+    float progress = mSettings.mNbFrames > 1 ? (float) frame / (mSettings.mNbFrames - 1) : 0;
+
+    switch(mSettings.mShape) {
+        case SHAPE_LINEAR: {
+            position = mSettings.mStartPosition + (mSettings.mEndPosition - mSettings.mStartPosition) * progress;
+            rotation = mSettings.mStartRotation + (mSettings.mEndRotation - mSettings.mStartRotation) * progress;
+            break;
+        }
+
+        case SHAPE_CIRCULAR: {
+            // Y coordinate decreases with the sine, so that increasing angles turn clockwise on the pitch
+            float angle = mSettings.mStartAngle + mSettings.mArc * progress;
+            float radians = angle * DEGTORAD;
+            position = vector3df(mSettings.mCenter.X + mSettings.mRadius * std::cos(radians),
+                                 mSettings.mCenter.Y - mSettings.mRadius * std::sin(radians),
+                                 mSettings.mHeight);
+
+            // Camera faces the center: yaw is 180 below it, and decreases as the angle increases
+            float yaw = std::fmod(90 - angle, 360.f);
+            if(yaw < 0)
+                yaw += 360;
+            rotation = vector3df(mSettings.mPitch, yaw, 0);
+            break;
+        }
+    }
+}
@@ -0,0 +1,142 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CAMERAPATHGENERATOR_H
+#define CAMERAPATHGENERATOR_H
+
+#include <ostream>
+#include <irrlicht.h>
+
+using namespace irr::core;
+
+enum CAMERA_SHAPE { SHAPE_LINEAR = 0, SHAPE_CIRCULAR = 1 };
+
+/**
+ * @brief Settings of a generated camera path
+ *
+ * Distances are in millimeters and angles in degrees, like the camera trajectory files.
+ */
+class CameraPathSettings
+{
+public:
+    /**
+     * Creates the settings of the circular move around the ISSIA pitch
+     */
+    CameraPathSettings() {
+        mShape = SHAPE_CIRCULAR;
+        mNbFrames = 2900;
+        mKeyframeInterval = 0;
+        mStartPosition = vector3df(0, 0, 0);
+        mEndPosition = vector3df(0, 0, 0);
+        mStartRotation = vector3df(0, 0, 0);
+        mEndRotation = vector3df(0, 0, 0);
+        mCenter = vector2df(52000, 36000);
+        mRadius = 40000;
+        mHeight = 20000;
+        mPitch = 30;
+        mStartAngle = 270;
+        mArc = 348;
+    }
+
+    /**
+     * Shape of the move
+     */
+    CAMERA_SHAPE mShape;
+
+    /**
+     * Number of frames of the move
+     */
+    int mNbFrames;
+
+    /**
+     * Number of frames between two written poses, for keyframed trajectories, or 0 to write every frame
+     */
+    int mKeyframeInterval;
+
+    /**
+     * Poses of the first and last frames of a linear move
+     */
+    vector3df mStartPosition;
+    vector3df mEndPosition;
+    vector3df mStartRotation;
+    vector3df mEndRotation;
+
+    /**
+     * Center of a circular move, on the ground
+     */
+    vector2df mCenter;
+
+    /**
+     * Radius of a circular move
+     */
+    float mRadius;
+
+    /**
+     * Height of the camera during a circular move
+     */
+    float mHeight;
+
+    /**
+     * Pitch of the camera during a circular move
+     */
+    float mPitch;
+
+    /**
+     * Angle of the camera around the center at the first frame of a circular move, 270 being on the side of
+     * the largest Y
+     */
+    float mStartAngle;
+
+    /**
+     * Angle covered by a circular move, negative to turn the other way
+     */
+    float mArc;
+};
+
+/**
+ * @brief Generates camera trajectories
+ *
+ * A linear move goes from a pose to another at constant speed, which also covers the rising moves. A circular
+ * move turns around a point of the ground, the camera always facing this point.
+ */
+class CameraPathGenerator
+{
+
+public:
+
+    /**
+     * Creates a generator
+     * @param settings settings of the path
+     */
+    explicit CameraPathGenerator(const CameraPathSettings& settings);
+
+    /**
+     * Writes the trajectory: every frame, or the keyframes and the last frame if a keyframe interval is set
+     * @param out camera trajectory: "frame x y z pitch yaw roll"
+     * @return number of lines written
+     */
+    int generate(std::ostream& out) const;
+
+private:
+
+    void getPose(int frame, vector3df& position, vector3df& rotation) const;
+
+    CameraPathSettings mSettings;
+};
+
+#endif // CAMERAPATHGENERATOR_H
@@ -0,0 +1,310 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "trajectorytransform.h"
+#include "camerapathgenerator.h"
+
+namespace
+{
+    void printUsage(const char* program)
+    {
+        std::cerr << "Usage: " << program << " transform [options] file..." << std::endl
+                  << "Transforms trajectory files, written next to them with a _transformed suffix" << std::endl
+                  << "  --type T         players, ball or camera (players)" << std::endl
+                  << "  --scale F        factor applied to positions (1)" << std::endl
+                  << "  --units A:B      converts positions from unit A to unit B, among m, cm and mm" << std::endl
+                  << "  --offset X,Y,Z   vector added to positions after scaling (0,0,0)" << std::endl
+                  << "  --frames N       number added to frame indexes (0)" << std::endl
+                  << "  --output DIR     directory of the transformed files, which keep their names" << std::endl
+                  << "  --jobs N         number of files transformed at once (one per processor core)" << std::endl
+                  << std::endl
+                  << "Usage: " << program << " camera [options] file" << std::endl
+                  << "Writes a camera trajectory" << std::endl
+                  << "  --shape S        linear or circular (circular)" << std::endl
+                  << "  --frames N       number of frames (2900)" << std::endl
+                  << "  --keyframes N    writes one frame out of N, for keyframed trajectories (every frame)" << std::endl
+                  << "  linear:   --from X,Y,Z --to X,Y,Z --from-rotation P,Y,R --to-rotation P,Y,R" << std::endl
+                  << "  circular: --center X,Y --radius R --height H --pitch P --start-angle A --arc A" << std::endl
+                  << "            (52000,36000 40000 20000 30 270 348)" << std::endl;
+    }
+
+    /**
+     * Parses comma-separated numbers, such as "1,2,3"
+     */
+    bool parseNumbers(const char* text, float* values, int nbValues)
+    {
+        for(int i = 0; i < nbValues; ++i) {
+            char* end = nullptr;
+            values[i] = strtof(text, &end);
+            if(end == text || *end != (i + 1 < nbValues ? ',' : '\0'))
+                return false;
+            text = end + 1;
+        }
+        return true;
+    }
+
+    bool parseVector(const char* text, vector3df& vector)
+    {
+        float values[3];
+        if(!parseNumbers(text, values, 3))
+            return false;
+        vector = vector3df(values[0], values[1], values[2]);
+        return true;
+    }
+
+    /**
+     * Returns path of the transformed file: same name in the output directory, or a suffixed name next to the input
+     */
+    std::string getOutputName(const std::string& inputName, const std::string& outputDirectory)
+    {
+        auto slash = inputName.find_last_of("/\\");
+        std::string baseName = (slash == std::string::npos) ? inputName : inputName.substr(slash + 1);
+        if(!outputDirectory.empty())
+            return outputDirectory + "/" + baseName;
+
+        auto dot = inputName.find_last_of('.');
+        if(dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            return inputName + "_transformed";
+        return inputName.substr(0, dot) + "_transformed" + inputName.substr(dot);
+    }
+
+    int runTransform(int argc, char* argv[])
+    {
+        TransformSettings settings;
+        std::string outputDirectory;
+        int nbJobs = (int) std::thread::hardware_concurrency();
+        std::vector<std::string> inputNames;
+        float unitFactor = 1;
+        for(int i = 2; i < argc; ++i) {
+            bool hasValue = i + 1 < argc;
+            if(strcmp(argv[i], "--type") == 0 && hasValue) {
+                std::string type = argv[++i];
+                if(type == "players")
+                    settings.mType = TRAJECTORY_PLAYERS;
+                else if(type == "ball")
+                    settings.mType = TRAJECTORY_BALL;
+                else if(type == "camera")
+                    settings.mType = TRAJECTORY_CAMERA;
+                else
+                    return -1;
+            } else if(strcmp(argv[i], "--scale") == 0 && hasValue) {
+                settings.mScale = (float) atof(argv[++i]);
+            } else if(strcmp(argv[i], "--units") == 0 && hasValue) {
+                std::string units = argv[++i];
+                auto colon = units.find(':');
+                if(colon == std::string::npos)
+                    return -1;
+                unitFactor = TrajectoryTransform::getUnitFactor(units.substr(0, colon), units.substr(colon + 1));
+                if(unitFactor == 0)
+                    return -1;
+            } else if(strcmp(argv[i], "--offset") == 0 && hasValue) {
+                if(!parseVector(argv[++i], settings.mOffset))
+                    return -1;
+            } else if(strcmp(argv[i], "--frames") == 0 && hasValue) {
+                settings.mFrameOffset = atoi(argv[++i]);
+            } else if(strcmp(argv[i], "--output") == 0 && hasValue) {
+                outputDirectory = argv[++i];
+            } else if(strcmp(argv[i], "--jobs") == 0 && hasValue) {
+                nbJobs = atoi(argv[++i]);
+            } else if(argv[i][0] != '-') {
+                inputNames.push_back(argv[i]);
+            } else {
+                return -1;
+            }
+        }
+        if(inputNames.empty())
+            return -1;
+        settings.mScale *= unitFactor;
+        nbJobs = std::max(1, std::min(nbJobs, (int) inputNames.size()));
+
+        TrajectoryTransform transform(settings);
+        std::atomic<unsigned int> nextFile(0);
+        std::atomic<int> nbFailed(0);
+        std::mutex printMutex;
+
+        // Each worker takes the next file until all are done, files being independent
+        auto work = [&]() {
+            // Large buffers, so that reading and writing are not a system call per line
+            std::vector<char> inputBuffer(1 << 20);
+            std::vector<char> outputBuffer(1 << 20);
+
+            for(unsigned int f = nextFile++; f < inputNames.size(); f = nextFile++) {
+                const std::string& inputName = inputNames[f];
+                std::string outputName = getOutputName(inputName, outputDirectory);
+
+                std::ostringstream report;
+                bool isFailed = true;
+                std::ifstream input;
+                std::ofstream output;
+                input.rdbuf()->pubsetbuf(inputBuffer.data(), inputBuffer.size());
+                output.rdbuf()->pubsetbuf(outputBuffer.data(), outputBuffer.size());
+                input.open(inputName.c_str());
+                if(outputName == inputName) {
+                    report << inputName << ": output would overwrite the input";
+                } else if(!input.is_open()) {
+                    report << inputName << ": file cannot be opened";
+                } else {
+                    output.open(outputName.c_str());
+                    if(!output.is_open()) {
+                        report << outputName << ": file cannot be created";
+                    } else {
+                        try {
+                            unsigned long nbLines = transform.transform(input, output);
+                            output.flush();
+                            if(output.good()) {
+                                report << inputName << " -> " << outputName << ": " << nbLines << " lines";
+                                isFailed = false;
+                            } else {
+                                report << outputName << ": file could not be written";
+                            }
+                        } catch(const std::runtime_error& e) {
+                            report << inputName << ": " << e.what();
+                        }
+
+                        // A truncated output must not be taken for a transformed file by a later run
+                        if(isFailed) {
+                            output.close();
+                            std::remove(outputName.c_str());
+                        }
+                    }
+                }
+
+                // Reports of the workers must not be interleaved
+                if(isFailed)
+                    ++nbFailed;
+                std::lock_guard<std::mutex> lock(printMutex);
+                (isFailed ? std::cerr : std::cout) << report.str() << std::endl;
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for(int i = 1; i < nbJobs; ++i)
+            workers.push_back(std::thread(work));
+        work();
+        for(auto& worker : workers)
+            worker.join();
+
+        return nbFailed == 0 ? 0 : 1;
+    }
+
+    int runCamera(int argc, char* argv[])
+    {
+        CameraPathSettings settings;
+        std::string outputName;
+        for(int i = 2; i < argc; ++i) {
+            bool hasValue = i + 1 < argc;
+            bool isValid = true;
+            if(strcmp(argv[i], "--shape") == 0 && hasValue) {
+                std::string shape = argv[++i];
+                if(shape == "linear")
+                    settings.mShape = SHAPE_LINEAR;
+                else if(shape == "circular")
+                    settings.mShape = SHAPE_CIRCULAR;
+                else
+                    isValid = false;
+            } else if(strcmp(argv[i], "--frames") == 0 && hasValue) {
+                settings.mNbFrames = atoi(argv[++i]);
+            } else if(strcmp(argv[i], "--keyframes") == 0 && hasValue) {
+                settings.mKeyframeInterval = atoi(argv[++i]);
+            } else if(strcmp(argv[i], "--from") == 0 && hasValue) {
+                isValid = parseVector(argv[++i], settings.mStartPosition);
+            } else if(strcmp(argv[i], "--to") == 0 && hasValue) {
+                isValid = parseVector(argv[++i], settings.mEndPosition);
+            } else if(strcmp(argv[i], "--from-rotation") == 0 && hasValue) {
+                isValid = parseVector(argv[++i], settings.mStartRotation);
+            } else if(strcmp(argv[i], "--to-rotation") == 0 && hasValue) {
+                isValid = parseVector(argv[++i], settings.mEndRotation);
+            } else if(strcmp(argv[i], "--center") == 0 && hasValue) {
+                float center[2] = { 0, 0 };
+                isValid = parseNumbers(argv[++i], center, 2);
+                if(isValid)
+                    settings.mCenter = vector2df(center[0], center[1]);
+            } else if(strcmp(argv[i], "--radius") == 0 && hasValue) {
+                settings.mRadius = (float) atof(argv[++i]);
+            } else if(strcmp(argv[i], "--height") == 0 && hasValue) {
+                settings.mHeight = (float) atof(argv[++i]);
+            } else if(strcmp(argv[i], "--pitch") == 0 && hasValue) {
+                settings.mPitch = (float) atof(argv[++i]);
+            } else if(strcmp(argv[i], "--start-angle") == 0 && hasValue) {
+                settings.mStartAngle = (float) atof(argv[++i]);
+            } else if(strcmp(argv[i], "--arc") == 0 && hasValue) {
+                settings.mArc = (float) atof(argv[++i]);
+            } else if(argv[i][0] != '-' && outputName.empty()) {
+                outputName = argv[i];
+            } else {
+                isValid = false;
+            }
+
+            if(!isValid)
+                return -1;
+        }
+        if(outputName.empty() || settings.mNbFrames < 1 || settings.mKeyframeInterval < 0)
+            return -1;
+
+        std::ofstream output(outputName.c_str());
+        if(!output.is_open()) {
+            std::cerr << "File cannot be created: " << outputName << std::endl;
+            return 1;
+        }
+
+        CameraPathGenerator generator(settings);
+        int nbLines = generator.generate(output);
+        output.flush();
+        if(!output.good()) {
+            std::cerr << "Camera trajectory could not be written: " << outputName << std::endl;
+            return 1;
+        }
+
+        std::cout << outputName << ": " << nbLines << " lines" << std::endl;
+        return 0;
+    }
+}
+
+/**
+ * Transforms trajectory files and generates camera trajectories, using the parser and the writer of the
+ * program so that the files always have its format
+ */
+int main(int argc, char* argv[])
+{
+    int status = -1;
+    if(argc >= 2 && strcmp(argv[1], "transform") == 0) {
+        status = runTransform(argc, argv);
+    } else if(argc >= 2 && strcmp(argv[1], "camera") == 0) {
+        status = runCamera(argc, argv);
+    }
+
+    // Invalid arguments
+    if(status < 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    return status;
+}
@@ -0,0 +1,105 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <stdexcept>
+#include "trajectoryparser.h"
+#include "trajectorywriter.h"
+#include "trajectorytransform.h"
+
+TrajectoryTransform::TrajectoryTransform(const TransformSettings& settings)
+{
+    mSettings = settings;
+}
+
+unsigned long TrajectoryTransform::transform(std::istream& in, std::ostream& out) const
+{
+    unsigned long lineNumber = 0;
+    unsigned long nbWritten = 0;
+    std::string line;
+    while(std::getline(in, line)) {
+        ++lineNumber;
+        if(line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        // Parser reports missing tokens with std::out_of_range, and tokens which are not numbers with
+        // std::invalid_argument (std::stoi and std::stof also report numbers too large with std::out_of_range)
+        try {
+            transformLine(line, out);
+        } catch(const std::out_of_range&) {
+            throw std::runtime_error("line " + std::to_string(lineNumber) + " is malformed (missing or too large value)");
+        } catch(const std::invalid_argument&) {
+            throw std::runtime_error("line " + std::to_string(lineNumber) + " is malformed (value is not a number)");
+        }
+        ++nbWritten;
+    }
+
+    return nbWritten;
+}
+
+float TrajectoryTransform::getUnitFactor(const std::string& from, const std::string& to)
+{
+    auto getMillimeters = [](const std::string& unit) {
+        if(unit == "m")
+            return 1000.f;
+        if(unit == "cm")
+            return 10.f;
+        if(unit == "mm")
+            return 1.f;
+        return 0.f;
+    };
+
+    float fromMillimeters = getMillimeters(from);
+    float toMillimeters = getMillimeters(to);
+    if(fromMillimeters == 0 || toMillimeters == 0)
+        return 0;
+
+    return fromMillimeters / toMillimeters;
+}
+
+void TrajectoryTransform::transformLine(const std::string& line, std::ostream& out) const
+{
+    switch(mSettings.mType) {
+        case TRAJECTORY_PLAYERS: {
+            int frame = 0, player = 0;
+            vector2df position;
+            std::tie(frame, player, position) = TrajectoryParser::getPlayerTokens(line);
+            position = position * mSettings.mScale + vector2df(mSettings.mOffset.X, mSettings.mOffset.Y);
+            TrajectoryWriter::writePlayerLine(out, frame + mSettings.mFrameOffset, player, position);
+            break;
+        }
+
+        case TRAJECTORY_BALL: {
+            int frame = 0;
+            vector3df position;
+            std::tie(frame, position) = TrajectoryParser::getBallTokens(line);
+            position = position * mSettings.mScale + mSettings.mOffset;
+            TrajectoryWriter::writeBallLine(out, frame + mSettings.mFrameOffset, position);
+            break;
+        }
+
+        case TRAJECTORY_CAMERA: {
+            int frame = 0;
+            vector3df position, rotation;
+            std::tie(frame, position, rotation) = TrajectoryParser::getCameraTokens(line);
+            position = position * mSettings.mScale + mSettings.mOffset;
+            TrajectoryWriter::writeCameraLine(out, frame + mSettings.mFrameOffset, position, rotation);
+            break;
+        }
+    }
+}
@@ -0,0 +1,112 @@
+/*
+ *  Copyright 2014 Pierre Walch
+ *  Website : www.pwalch.net
+ *
+ *  Avatars is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  Avatars is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with Avatars.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRAJECTORYTRANSFORM_H
+#define TRAJECTORYTRANSFORM_H
+
+#include <string>
+#include <istream>
+#include <ostream>
+#include <irrlicht.h>
+
+using namespace irr::core;
+
+enum TRAJECTORY_TYPE { TRAJECTORY_PLAYERS = 0, TRAJECTORY_BALL = 1, TRAJECTORY_CAMERA = 2 };
+
+/**
+ * @brief Settings of a trajectory transform
+ *
+ * Positions are first multiplied by the scale, then moved by the offset, which is therefore in the output
+ * unit. Rotations of camera trajectories are kept.
+ */
+class TransformSettings
+{
+public:
+    /**
+     * Creates the settings of a transform keeping the trajectories unchanged
+     */
+    TransformSettings() {
+        mType = TRAJECTORY_PLAYERS;
+        mScale = 1;
+        mOffset = vector3df(0, 0, 0);
+        mFrameOffset = 0;
+    }
+
+    /**
+     * Kind of trajectory file, which gives the format of its lines
+     */
+    TRAJECTORY_TYPE mType;
+
+    /**
+     * Factor applied to positions, for instance 1000 to convert meters to millimeters
+     */
+    float mScale;
+
+    /**
+     * Vector added to positions after scaling. Player trajectories only use X and Y.
+     */
+    vector3df mOffset;
+
+    /**
+     * Number added to frame indexes, for instance to append a sequence to another
+     */
+    int mFrameOffset;
+};
+
+/**
+ * @brief Streaming transform of trajectory files
+ *
+ * Lines are read with TrajectoryParser and written with TrajectoryWriter one at a time, so that files of any
+ * length are transformed in constant memory.
+ */
+class TrajectoryTransform
+{
+
+public:
+
+    /**
+     * Creates a transform
+     * @param settings settings of the transform
+     */
+    explicit TrajectoryTransform(const TransformSettings& settings);
+
+    /**
+     * Transforms all the lines of a trajectory, empty lines being dropped. A malformed line throws a
+     * std::runtime_error giving its number.
+     * @param in trajectory to read
+     * @param out trajectory to write
+     * @return number of lines written
+     */
+    unsigned long transform(std::istream& in, std::ostream& out) const;
+
+    /**
+     * Returns the factor converting a distance unit into another
+     * @param from unit of the input: "m", "cm" or "mm"
+     * @param to unit of the output: "m", "cm" or "mm"
+     * @return factor, or 0 if a unit is unknown
+     */
+    static float getUnitFactor(const std::string& from, const std::string& to);
+
+private:
+
+    void transformLine(const std::string& line, std::ostream& out) const;
+
+    TransformSettings mSettings;
+};
+
+#endif // TRAJECTORYTRANSFORM_H